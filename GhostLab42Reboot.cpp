@@ -9,11 +9,86 @@
 #include <Wire.h>
 #include "GhostLab42Reboot.h"
 
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+// Reads a byte from a table stored in flash (PROGMEM), so the table does not
+// take up any RAM. Boards that do not keep flash separate from RAM define
+// pgm_read_byte() as a normal read.
+static inline byte readTable(const byte *table, int index)
+{
+  return pgm_read_byte(&table[index]);
+}
+
+// Returns the shorter of a wait and the time from now until a deadline, or 0
+// if the deadline has passed. Works across the wrap of millis() and micros().
+static inline unsigned long earlierWait(unsigned long wait, unsigned long due,
+                                        unsigned long now)
+{
+  long left = (long)(due - now);
+  if (left <= 0) return 0;
+  return ((unsigned long)left < wait) ? (unsigned long)left : wait;
+}
+
+// Converts a safe Lighting Effect Register current setting into mA
+// Settings from 0x08 up count in steps of 5mA
+static byte currentMilliamps(byte setting)
+{
+  return (setting - 0x07) * 5;
+}
+
+#if REBOOT_ENABLE_PRINT
+// Converts a number into its digits for printf() and returns the number of
+// digits. Digits above 9 are upper or lower case letters.
+static byte formatNumber(char digits[], unsigned long value, byte base,
+                         bool upperCase)
+{
+  byte length = 0;
+
+  // The digits come out backwards
+  do
+  {
+    byte digit = value % base;
+    value /= base;
+
+    if (digit < 10) digits[length] = '0' + digit;
+    else digits[length] = (upperCase ? 'A' : 'a') + digit - 10;
+    length++;
+  } while (value != 0);
+
+  for (byte i = 0; i < length / 2; i++)
+  {
+    char swap = digits[i];
+    digits[i] = digits[length - 1 - i];
+    digits[length - 1 - i] = swap;
+  }
+
+  return length;
+}
+#endif
+
 // Each I2C has a unique bus address
 #define IS31FL3730_DIGIT_4_I2C_ADDRESS  0x63  // 4 digit IS31FL3730 display
 #define IS31FL3730_DIGIT_4S_I2C_ADDRESS 0x61  // 4 digit IS31FL3730 display (smaller)
 #define IS31FL3730_DIGIT_6_I2C_ADDRESS  0x60  // 6 digit IS31FL3730 display
 
+// Default address of the I2C multiplexer (TCA9548A) in front of the mirrors
+#define TCA9548A_I2C_ADDRESS 0x70
+
+// Number of channels on the I2C multiplexer
+const byte TCA9548A_Channel_Count = 8;
+
+// "Configuration Register" index in the IS31FL3730
+// Bit 7 is the software shutdown bit. While shut down the display is dark,
+// but the data registers and all other settings are kept, so the display can
+// be turned off and on again without re-sending what it shows.
+// The remaining bits select the matrix mode, which is left at the default
+// (8x8 matrix, matrix 1 only).
+const byte IS31FL3730_Configuration_Register = 0x00;
+const byte IS31FL3730_Configuration_Normal   = 0x00;
+const byte IS31FL3730_Configuration_Shutdown = 0x80;
+
 // "Matrix 1 Data Register" index in the IS31FL3730
 // 8-bit value to define which segments are lit.
 // This is the starting index. Sequential bytes will go to the next
@@ -29,10 +104,27 @@ const byte IS31FL3730_Update_Column_Register = 0x0C;
 // "Lighting Effect Register" index in the IS31FL3730
 const byte IS31FL3730_Lighting_Effect_Register = 0x0D;
 
+// Current settings for the Lighting Effect Register that are safe for the
+// displays (see currenttable.md), from lowest to highest. Anything above 20mA
+// is too much for the displays.
+const byte IS31FL3730_Current_Settings[] PROGMEM = { 0x08, 0x09, 0x0A, 0x0B };
+const byte IS31FL3730_Current_Milliamps[] PROGMEM = { 5, 10, 15, 20 };
+const byte IS31FL3730_Current_Setting_Count = 4;
+
+// Highest current setting the displays can take (20mA)
+const byte IS31FL3730_Current_Max = 0x0B;
+
+// The IS31FL3730 scans the 8 columns of its matrix one after the other, so
+// each segment only gets its current an eighth of the time
+const byte IS31FL3730_Scan_Columns = 8;
+
 // "PWM Register" index in the IS31FL3730
 // The PWM Register can modulate LED light at 128 different points
 const byte IS31FL3730_PWM_Register = 0x19;
 
+// Value of the PWM Register after the IS31FL3730 is reset (full brightness)
+const byte IS31FL3730_PWM_Default = 0x80;
+
 // "Reset Register" index in the IS31FL3730
 // Once user writes any 8-bit data to the Reset Register, IS31FL3730 will reset
 // all registers to default value
@@ -43,7 +135,7 @@ const byte IS31FL3730_Reset_Register = 0xFF;
 // Light correction lookup table for the led displays
 // Human eyes do not view light linearly, so this corrects for that using
 // the CIE 1931 formula (see developer documentation)
-const byte lightCorrectionTable[] =
+const byte lightCorrectionTable[] PROGMEM =
 {
     0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02,
     0x02, 0x02, 0x02, 0x02, 0x03, 0x03, 0x03, 0x04, 0x04, 0x04, 0x04, 0x05,
@@ -56,11 +148,304 @@ const byte lightCorrectionTable[] =
     0x73, 0x76, 0x79, 0x7D, 0x80
 };
 
+#if REBOOT_ENABLE_ORIENTATION
+// Segment maps for the ways a display can be mounted. Turning a digit upside
+// down swaps a with d, b with e and c with f. Mirroring it swaps b with f and
+// c with e (left and right), or a with d, b with c and e with f (top and
+// bottom). The decimal stays where it is, since the digits only have one.
+const byte Segment_Map_Rotate_180[256] PROGMEM =
+  REBOOT_SEGMENT_MAP(3, 4, 5, 0, 1, 2, 6, 7);
+const byte Segment_Map_Mirror_Horizontal[256] PROGMEM =
+  REBOOT_SEGMENT_MAP(0, 5, 4, 3, 2, 1, 6, 7);
+const byte Segment_Map_Mirror_Vertical[256] PROGMEM =
+  REBOOT_SEGMENT_MAP(3, 2, 1, 0, 5, 4, 6, 7);
+#endif
+
+// Glyph table of the default font, from ' ' to DEL (gfedcba format)
+// Letters are the same in upper and lower case, and M and W take up two digits
+const byte Default_Font_First = ' ';
+const byte Default_Font_Glyphs[] PROGMEM =
+{
+  0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //   ! " # $ % & '
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, // ( ) * + , - . /
+  0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, // 0 1 2 3 4 5 6 7
+  0x7F, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA3, // 8 9 : ; < = > ?
+  0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D, // @ A B C D E F G
+  0x76, 0x06, 0x1E, 0x76, 0x38, 0xFF, 0x54, 0x3F, // H I J K L M N O
+  0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x3E, 0xFF, // P Q R S T U V W
+  0x76, 0x6E, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00, // X Y Z [ \ ] ^ _
+  0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D, // ` a b c d e f g
+  0x76, 0x06, 0x1E, 0x76, 0x38, 0xFF, 0x54, 0x3F, // h i j k l m n o
+  0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x3E, 0xFF, // p q r s t u v w
+  0x76, 0x6E, 0x5B, 0x00, 0x00, 0x00, 0x00, 0x00  // x y z { | } ~ DEL
+};
+
+// Glyphs of the default font that take up two digits
+const RebootGlyph Default_Font_Extras[] PROGMEM =
+{
+  { 'M', 2, { 0x33, 0x27 } },
+  { 'm', 2, { 0x33, 0x27 } },
+  { 'W', 2, { 0x3C, 0x1E } },
+  { 'w', 2, { 0x3C, 0x1E } }
+};
+
+const RebootFont rebootDefaultFont =
+{
+  Default_Font_First, sizeof(Default_Font_Glyphs), Default_Font_Glyphs,
+  sizeof(Default_Font_Extras) / sizeof(RebootGlyph), Default_Font_Extras,
+  NULL
+};
+
+// Glyphs of the alternate font, which only has the characters that differ
+// from the default font: K with a slanted side, X as two bars, S without the
+// bottom left corner of 5, V as a small u, and Z with a bar through it
+const RebootGlyph Alternate_Font_Extras[] PROGMEM =
+{
+  { 'K', 1, { 0x75 } },
+  { 'k', 1, { 0x75 } },
+  { 'X', 1, { 0x36 } },
+  { 'x', 1, { 0x36 } },
+  { 'S', 1, { 0x2D } },
+  { 's', 1, { 0x2D } },
+  { 'V', 1, { 0x1C } },
+  { 'v', 1, { 0x1C } },
+  { 'Z', 1, { 0x49 } },
+  { 'z', 1, { 0x49 } }
+};
+
+const RebootFont rebootAlternateFont =
+{
+  0, 0, NULL,
+  sizeof(Alternate_Font_Extras) / sizeof(RebootGlyph), Alternate_Font_Extras,
+  &rebootDefaultFont
+};
+
+// Transition modes
+const byte Transition_None      = 0;
+const byte Transition_Crossfade = 1; // Frames alternate, blending them
+const byte Transition_Dip       = 2; // Fade out with PWM, swap, fade back in
+const byte Transition_Segments  = 3; // Precomputed segment changes
+
+// Segments (gfedcba format) that the top down wipe switches in each step:
+// a, then b and f, then g, then c and e, then d and the decimal
+const byte Wipe_Top_Down_Bands[] PROGMEM = { 0x01, 0x22, 0x40, 0x14, 0x88 };
+
+// Longest crossfade sub-frame (ms) that still blends the frames instead of
+// visibly flickering between them
+const unsigned long Crossfade_Max_Subframe = 20;
+
+// Number of digits on each display, indexed by display ID
+const byte displayDigits[REBOOT_DISPLAY_COUNT] PROGMEM = { 6, 4, 4 };
+
+// Returns the number of digits on the display
+static inline byte digitCount(int displayID)
+{
+  return readTable(displayDigits, displayID);
+}
+
+#if REBOOT_FRAME_CLOCK > 0
+#if defined(__AVR__) && (REBOOT_FRAME_CLOCK == 1 || REBOOT_FRAME_CLOCK == 2)
+#define REBOOT_FRAME_CLOCK_TIMER REBOOT_FRAME_CLOCK
+#else
+#define REBOOT_FRAME_CLOCK_TIMER 0
+#endif
+
+#if REBOOT_FRAME_CLOCK_TIMER > 0
+// The timer interrupt cannot reach the GhostLab42Reboot object, so the
+// frames that are due and the micros() the last one came due at are kept
+// here. There is only one timer, so there is only one frame clock.
+static volatile byte frameClockTicks = 0;
+static volatile unsigned long frameClockTime = 0;
+
+// Counts a frame that is due, from the timer interrupt
+static inline void frameClockTick()
+{
+  frameClockTime = micros();
+  if (frameClockTicks < 255) frameClockTicks++;
+}
+#endif
+
+#if REBOOT_FRAME_CLOCK_TIMER == 1
+ISR(TIMER1_COMPA_vect)
+{
+  frameClockTick();
+}
+#elif REBOOT_FRAME_CLOCK_TIMER == 2
+// Timer2 only counts to 255, so it interrupts every millisecond and the
+// milliseconds are counted down to the next frame
+static volatile unsigned int frameClockCountdown = 0;
+static unsigned int frameClockMs = 0;
+
+ISR(TIMER2_COMPA_vect)
+{
+  if (--frameClockCountdown != 0) return;
+  frameClockCountdown = frameClockMs;
+  frameClockTick();
+}
+#endif
+#endif
+
 /******************************************************************************
  *                                Constructor                                 *
  ******************************************************************************/
 
-GhostLab42Reboot::GhostLab42Reboot(){}
+GhostLab42Reboot::GhostLab42Reboot()
+{
+#if REBOOT_ENABLE_PRINT
+  for (int i = 0; i <= REBOOT_DISPLAY_COUNT; i++)
+  {
+    printDisplays[i].reboot = this;
+    printDisplays[i].displayID = i;
+  }
+#endif
+
+#if REBOOT_ENABLE_CLOCK
+  timeSource = NULL;
+#endif
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+  idleTimeout = 0;
+#endif
+#if REBOOT_ENABLE_CURRENT_BUDGET
+  currentBudget = 0;
+#endif
+
+#if REBOOT_FRAME_CLOCK > 0
+  frameClockPeriod = 0;
+  frameClockNext = 0;
+  missedFrames = 0;
+#endif
+
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+  autoBrightnessPin = -1;
+  autoBrightnessDark = 0;
+  autoBrightnessBright = 1023;
+  autoBrightnessMin = 0;
+  autoBrightnessMax = 100;
+  autoBrightnessInterval = 50;
+  autoBrightnessLastSample = 0;
+  autoBrightnessSamples = 4;
+  autoBrightnessSmoothing = 3;
+  autoBrightnessThreshold = 2;
+  autoBrightnessPrimed = false;
+  autoBrightnessFiltered = 0;
+  autoBrightnessOutput = 0;
+#endif
+
+#if REBOOT_ENABLE_STATISTICS
+  busTransactions = 0;
+  busBytes = 0;
+#endif
+#if REBOOT_TRACE_SPANS > 0
+  traceNext = 0;
+  traceCount = 0;
+  traceDropped = 0;
+  transactionStart = 0;
+  transactionAddress = 0;
+#endif
+#if REBOOT_ENABLE_TRANSITIONS
+  crossfadeSubframe = 5;
+  crossfadeBusBudget = 0;
+#endif
+
+#if REBOOT_ENABLE_GROUPS
+  for (int i = 0; i < REBOOT_GROUP_COUNT; i++)
+  {
+    groupMembers[i] = 0;
+    memset(groupScale[i], 100, sizeof(groupScale[i]));
+    groupLevel[i] = 100;
+    groupFadeFrom[i] = 100;
+    groupFadeTo[i] = 100;
+    groupFadeStart[i] = 0;
+    groupFadeDuration[i] = 0;
+  }
+#endif
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    memset(frameBuffer[i], 0, sizeof(frameBuffer[i]));
+    clearDirty(i);
+    displayPWM[i] = IS31FL3730_PWM_Default;
+    displayMaxCurrent[i] = IS31FL3730_Current_Max;
+    outputPWM[i] = IS31FL3730_PWM_Default;
+    displayCurrent[i] = IS31FL3730_Current_Max;
+#if REBOOT_ENABLE_CURRENT_BUDGET
+    targetPWM[i] = IS31FL3730_PWM_Default;
+    targetCurrent[i] = IS31FL3730_Current_Max;
+#endif
+    displayBlanked[i] = false;
+#if REBOOT_ENABLE_BLINK
+    blinkPeriod[i] = 0;
+    blinkOnTime[i] = 0;
+    blinkStart[i] = 0;
+#endif
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+    lastActivity[i] = 0;
+    displayAsleep[i] = false;
+#endif
+#if REBOOT_ENABLE_STATISTICS
+    powerState[i] = REBOOT_POWER_ON;
+    powerStateSince[i] = 0;
+    memset(powerStateTime[i], 0, sizeof(powerStateTime[i]));
+#endif
+#if REBOOT_ENABLE_TRANSITIONS
+    transitionMode[i] = Transition_None;
+#if REBOOT_ENABLE_STATISTICS
+    transitionBytes[i] = 0;
+    transitionTransactions[i] = 0;
+#endif
+#endif
+#if REBOOT_ENABLE_CANVAS
+    canvasOrder[i] = i;
+#endif
+#if REBOOT_ENABLE_ORIENTATION
+    segmentMap[i] = NULL;
+    reverseColumns[i] = false;
+#endif
+#if REBOOT_ENABLE_FONTS
+    displayFont[i] = &rebootDefaultFont;
+#endif
+#if REBOOT_MIRROR_COUNT > 0
+    memset(registerData[i], 0, sizeof(registerData[i]));
+    registerPWM[i] = IS31FL3730_PWM_Default;
+    registerConfig[i] = IS31FL3730_Configuration_Normal;
+#endif
+  }
+
+#if REBOOT_ENABLE_FONTS && REBOOT_ENABLE_CANVAS
+  canvasFont = &rebootDefaultFont;
+#endif
+
+#if REBOOT_FRAME_CACHE > 0
+  memset(cacheLastUse, 0, sizeof(cacheLastUse));
+  cacheUses = 0;
+#endif
+#if REBOOT_ENABLE_STATISTICS && REBOOT_FRAME_CACHE > 0
+  cacheHits = 0;
+  cacheMisses = 0;
+#endif
+#if REBOOT_MIRROR_COUNT > 0
+  mirrorCount = 0;
+  muxAddress = TCA9548A_I2C_ADDRESS;
+  muxSelected = -1;
+#endif
+
+#if REBOOT_ENABLE_CANVAS
+  canvasLength = 0;
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    canvasLength += digitCount(i);
+  }
+#endif
+
+#if REBOOT_ENABLE_SCROLL
+  scrollLength = 0;
+  scrollOffset = 0;
+  scrollRepeat = false;
+  scrolling = false;
+  scrollInterval = 0;
+  scrollLastStep = 0;
+#endif
+}
 
 /*
  * Acts as the Constructor
@@ -72,10 +457,19 @@ void GhostLab42Reboot::begin()
 {
     Wire.begin();
 
-    // Set the maximum display power for all of the displays
-    setDisplayPowerMax(0);
-    setDisplayPowerMax(1);
-    setDisplayPowerMax(2);
+    // Set the display current for all of the displays
+    refreshDisplayCurrent(0);
+    refreshDisplayCurrent(1);
+    refreshDisplayCurrent(2);
+
+    // Start keeping track of the time spent in each power state
+    for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+    {
+      markActivity(i);
+#if REBOOT_ENABLE_STATISTICS
+      powerStateSince[i] = clockMillis();
+#endif
+    }
 }
 
 /******************************************************************************
@@ -91,73 +485,161 @@ void GhostLab42Reboot::write(int displayID, String value)
   // Verify the display exists before attempting to write to it
   if (verifyDisplayID(displayID) == false) return;
 
-  // Make sure the maximum current for the display is not exceeded
-  setDisplayPowerMax(displayID);
+  // Send the digits that were written to the display
+  encodeFrame(displayID, value);
+  commitFrame(displayID);
+}
 
-  // Write the display data in the temporary registers
-  setupWireTransmission(displayID);
-  Wire.write(IS31FL3730_Data_Registers);
+/*
+ * Writes the characters to the selected display, lined up to the left, right
+ * or center. All of the digits are written, so digits that are not filled are
+ * blanked. Characters that do not fit are cut off on the side away from the
+ * alignment (both sides when centered).
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * value     String with the value that you would like to display
+ * alignment REBOOT_ALIGN_LEFT, REBOOT_ALIGN_RIGHT or REBOOT_ALIGN_CENTER
+ * overflow  REBOOT_OVERFLOW_TRUNCATE, or REBOOT_OVERFLOW_ELLIPSIS to show a
+ *           decimal in place of the last digit that fits where characters
+ *           were cut off
+ */
+void GhostLab42Reboot::write(int displayID, String value, int alignment,
+                             int overflow)
+{
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return;
 
-  // Character array that stores the substring that is to be written
-  char substringValue[2];
+  byte cells[REBOOT_MAX_DIGITS];
+  layoutCells(currentFont(displayID), value.c_str(), cells,
+              digitCount(displayID),
+              alignment, overflow);
 
-  // Iterate over the print value and print out the individual characters
-  // Any string that goes over the number of digits gets cut off
-  // Any string that goes under the number of digits has blank spaces in
-  // in the remaining spots
-  for (int i = 0; i < value.length(); i++)
+  for (byte i = 0; i < digitCount(displayID); i++)
   {
-    // Determine how the character should be written
-    // Handle decimal as first character
-    if (value.charAt(i) == '.' and (i == 0 || value.charAt(i - 1) == '.'))
-    {
-      substringValue[0] = ' ';
-      substringValue[1] = value.charAt(i);
-    }
-    // Handle decimal after a regular character
-    else if (value.charAt(i + 1) == '.')
-    {
-      // There is a decimal, write it as part of the character
-      // Prepare the substring
-      substringValue[0] = value.charAt(i);
-      substringValue[1] = value.charAt(i + 1);
+    setCell(displayID, i, cells[i]);
+  }
 
-      // Skip the decimal
-      i++;
-    }
-    else
-    {
-      // There isn't a decimal, write the character normally
-      // Prepare the substring
-      substringValue[0] = value.charAt(i);
-    }
+  commitFrame(displayID);
+}
+
+/*
+ * Returns the number of digits the characters take up on the display. A
+ * decimal is part of the character before it, unless it is at the start or
+ * follows another decimal.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * value     String with the value to measure
+ */
+int GhostLab42Reboot::getTextWidth(int displayID, String value)
+{
+  if (verifyDisplayID(displayID) == false) return 0;
 
-    // Write the substring
-    writeCharacter(substringValue);
+  return encodeCells(currentFont(displayID), value.c_str(), NULL, 0, 0);
+}
 
-    // Clear out the substring array
-    memset(&substringValue[0], 0, sizeof(substringValue));
+#if REBOOT_ENABLE_PRINT
+/*
+ * Returns the Print interface of the display, so that print() and println()
+ * can write to it, for example reboot.display(0).println(temperature, 1).
+ * Nothing is sent to the display until the line is finished with a newline
+ * or flush().
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+RebootDisplay &GhostLab42Reboot::display(int displayID)
+{
+  // Anything printed to a display that does not exist is ignored
+  if (verifyDisplayID(displayID) == false)
+  {
+    return printDisplays[REBOOT_DISPLAY_COUNT];
   }
 
-  // End the temporary register transmission
-  Wire.endTransmission();
+  return printDisplays[displayID];
+}
 
-  // Set the current again, in case a wire was unplugged sometime between
-  // the last current reset and now
-  setDisplayPowerMax(displayID);
+/*
+ * Writes formatted characters to the display, like printf(). The formatting
+ * is done by the library, which is much smaller than the printf() of the C
+ * library and does not need a buffer or a String. The characters are
+ * converted straight into segment data as they are formatted, and then
+ * replace everything on the display (see display()). Returns the number of
+ * characters that were formatted.
+ *
+ * Supported conversions are %d, %i, %u, %x, %X, %c, %s and %%, with the "l"
+ * length modifier for long numbers, a width, and the "0" (pad with zeros) and
+ * "-" (line up on the left) flags. For example "%3d.%1d", "%04X" or "E%02u".
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * format    Format of the characters
+ * ...       Values for the conversions in the format
+ */
+int GhostLab42Reboot::printf(int displayID, const char *format, ...)
+{
+  RebootDisplay &out = display(displayID);
 
-  // Transfer the display data from the temporary registers to the display
-  setupWireTransmission(displayID);
+  va_list args;
+  va_start(args, format);
+  int count = formatText(out, format, false, args);
+  va_end(args);
 
-  // Write to the Update Column Register to let the board know we want to
-  // update the display
-  Wire.write(IS31FL3730_Update_Column_Register);
+  out.flush();
+  return count;
+}
 
-  // Send any value to initate the display (value ignored)
-  Wire.write(0x00);
+/*
+ * Writes formatted characters to the display, like printf(), with the format
+ * stored in flash with F()
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * format    Format of the characters, in flash
+ * ...       Values for the conversions in the format
+ */
+int GhostLab42Reboot::printf(int displayID, const __FlashStringHelper *format,
+                             ...)
+{
+  RebootDisplay &out = display(displayID);
 
-  // End the Updte Column Register Transmission
-  Wire.endTransmission();
+  va_list args;
+  va_start(args, format);
+  int count = formatText(out, (const char *)format, true, args);
+  va_end(args);
+
+  out.flush();
+  return count;
+}
+#endif
+
+/*
+ * Returns the number of writes that were found in the frame cache, and did not
+ * have to be converted again. Always 0 when the cache is turned off
+ * (REBOOT_FRAME_CACHE is 0).
+ */
+unsigned long GhostLab42Reboot::getFrameCacheHits()
+{
+#if REBOOT_ENABLE_STATISTICS && REBOOT_FRAME_CACHE > 0
+  return cacheHits;
+#else
+  return 0;
+#endif
+}
+
+/*
+ * Returns the number of writes that were not found in the frame cache, and
+ * had to be converted. Always 0 when the cache is turned off
+ * (REBOOT_FRAME_CACHE is 0).
+ */
+unsigned long GhostLab42Reboot::getFrameCacheMisses()
+{
+#if REBOOT_ENABLE_STATISTICS && REBOOT_FRAME_CACHE > 0
+  return cacheMisses;
+#else
+  return 0;
+#endif
 }
 
 /*
@@ -172,19 +654,36 @@ void GhostLab42Reboot::resetDisplay(int displayID)
   if (verifyDisplayID(displayID) == false) return;
 
   // Make sure the maximum current for the display is not exceeded
-  setDisplayPowerMax(displayID);
-
-  setupWireTransmission(displayID);
+  refreshDisplayCurrent(displayID);
 
   // Reset the display so that the display is blank
   // Send any value to reset the display (value ignored)
-  Wire.write(IS31FL3730_Reset_Register);
-  Wire.write(0x00);
-  Wire.endTransmission();
+  writeRegister(displayID, IS31FL3730_Reset_Register, 0x00);
+
+  // The reset also clears the software shutdown bit, the PWM register and
+  // the data registers
+  displayBlanked[displayID] = false;
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+  displayAsleep[displayID] = false;
+#endif
+#if REBOOT_ENABLE_TRANSITIONS
+  transitionMode[displayID] = Transition_None;
+#endif
+  displayPWM[displayID] = IS31FL3730_PWM_Default;
+  outputPWM[displayID] = IS31FL3730_PWM_Default;
+  memset(frameBuffer[displayID], 0, sizeof(frameBuffer[displayID]));
+  clearDirty(displayID);
+  updatePowerState(displayID);
+  markActivity(displayID);
 
   // Reset the current again, just to be careful since the display
   // was just reset
-  setDisplayPowerMax(displayID);
+  refreshDisplayCurrent(displayID);
+
+  // The display no longer draws any current, which leaves more of the
+  // current budget for the others
+  beginCurrentChange();
+  endCurrentChange();
 }
 
 /**
@@ -199,175 +698,3501 @@ void GhostLab42Reboot::setDisplayBrightness (int displayID, int brightness)
   // Verify the display exists before attempting to set its brightness
   if (verifyDisplayID(displayID) == false) return;
 
-  // Make sure the maximum current for the display is not exceeded
-  setDisplayPowerMax(displayID);
+  if (brightness < 0) brightness = 0;
+  if (brightness > 100) brightness = 100;
 
-  // Begin dimming the display
-  setupWireTransmission(displayID);
+  // Remember the brightness so it can be restored when the display wakes up
+  displayPWM[displayID] = readTable(lightCorrectionTable, brightness);
+  markActivity(displayID);
+
+  // A display that went idle gets the new brightness as part of waking up
+  if (displayIdle(displayID))
+  {
+    wakeDisplay(displayID);
+    return;
+  }
+
+  // Make room in the current budget before the display gets brighter
+  beginCurrentChange();
 
   // Tell the lighting effect register to display at the desired
   // brightness level with values from the light correction lookup table
-  Wire.write(IS31FL3730_PWM_Register);
-  Wire.write(lightCorrectionTable[brightness]);
-  Wire.endTransmission();
-}
+  // (limited by the current budget). This also makes sure the maximum
+  // current for the display is not exceeded.
+  writeDisplayOutput(displayID, true);
 
-/******************************************************************************
- *                             Private Functions                              *
- ******************************************************************************/
+  endCurrentChange();
+}
 
 /*
- * Makes sure the user passes the library a valid display ID
+ * Turns the display off without losing what it is showing. Only the
+ * software shutdown bit is changed, so this is a single short I2C write and
+ * unblank() brings the same content back.
+ *
+ * Stops the blink effect if it is running on the display.
  *
  * Parameters:
  * displayID Unique identifier for the display
  */
-bool GhostLab42Reboot::verifyDisplayID(int displayID)
+void GhostLab42Reboot::blank(int displayID)
 {
-  // User can technically give us any ID
-  // If they give us a bad ID, return false
-  return (displayID != 0 || displayID != 1 || displayID != 2);
+  // Verify the display exists before attempting to blank it
+  if (verifyDisplayID(displayID) == false) return;
+
+#if REBOOT_ENABLE_BLINK
+  blinkPeriod[displayID] = 0;
+#endif
+
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+  // A blanked display is already off, so it no longer counts as idle
+  displayAsleep[displayID] = false;
+#endif
+  setDisplayShutdown(displayID, true);
 }
 
 /*
- * Sets the current to the minimum (5mA per segment)
- * Not currently in use by the library, but it is good to keep it around
- * as an option for more advanced users
+ * Turns a display that was blanked back on, showing the same content it had
+ * before it was blanked
+ *
+ * Stops the blink effect if it is running on the display.
  *
  * Parameters:
  * displayID Unique identifier for the display
  */
-void GhostLab42Reboot::setDisplayPowerMin(int displayID)
+void GhostLab42Reboot::unblank(int displayID)
 {
-  setupWireTransmission(displayID);
+  // Verify the display exists before attempting to unblank it
+  if (verifyDisplayID(displayID) == false) return;
 
-  Wire.write(IS31FL3730_Lighting_Effect_Register);
-  Wire.write(0x08); // Lowest level, 10mA
-  Wire.endTransmission();
+#if REBOOT_ENABLE_BLINK
+  blinkPeriod[displayID] = 0;
+#endif
+  markActivity(displayID);
+  wakeDisplay(displayID);
+  setDisplayShutdown(displayID, false);
 }
 
+#if REBOOT_ENABLE_BLINK
 /*
- * Sets the current to the maximum allowed for these displays (0mA per segment)
+ * Blinks the display by blanking and unblanking it. The blinking is driven by
+ * tick(), which needs to be called regularly from loop().
  *
  * Parameters:
  * displayID Unique identifier for the display
+ * periodMs  Length of one on/off cycle in milliseconds. Use 0 to stop
+ *           blinking and leave the display on.
+ * duty      Percentage of the period (0 - 100) the display is on
  */
-void GhostLab42Reboot::setDisplayPowerMax(int displayID)
+void GhostLab42Reboot::blink(int displayID, unsigned long periodMs, int duty)
 {
-  // The display driver allows currents greater than the displays should
-  // take - do not allow anything over 20mA!
-  // The display driver resets to 40mA per segment which is too much. This
-  // should be called before every function that writes to the display to
-  // ensure that the current is not exceeded in the case that a wire is
-  // accidentally disconnected
+  // Verify the display exists before attempting to blink it
+  if (verifyDisplayID(displayID) == false) return;
 
-  setupWireTransmission(displayID);
+  if (duty < 0) duty = 0;
+  if (duty > 100) duty = 100;
 
-  Wire.write(IS31FL3730_Lighting_Effect_Register);
-  Wire.write(0x0B); // Highest level, 20mA
-  Wire.endTransmission();
+  blinkPeriod[displayID] = periodMs;
+  blinkOnTime[displayID] = periodMs * duty / 100;
+  blinkStart[displayID] = clockMillis();
+
+  // Blinking displays never go idle
+  markActivity(displayID);
+  wakeDisplay(displayID);
+
+  // Start the cycle with the display on, or leave it on if blinking stopped
+  setDisplayShutdown(displayID, periodMs != 0 && duty == 0);
 }
+#endif
 
 /*
- * Set up the Wire transmission depending on the display being used
- *
- * Parameters:
- * displayID Unique identifier for the display
+ * Runs the time based effects (like blink), the idle timeout and the automatic
+ * brightness. Call this from loop() as often as possible. The displays are
+ * only written to when an effect needs to change what they show. Returns the
+ * milliseconds until the next effect step, or REBOOT_NO_DEADLINE if nothing
+ * is scheduled, so the loop can sleep() until then.
  */
-void GhostLab42Reboot::setupWireTransmission(int displayID)
+unsigned long GhostLab42Reboot::tick()
 {
-  if (displayID == 0)
+  unsigned long tickStart = traceStart();
+  unsigned long now = clockMillis();
+
+  // Nothing reads the time when all of the effects are left out
+  (void)now;
+
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+  // Read the light sensor
+  if (autoBrightnessPin >= 0 &&
+      now - autoBrightnessLastSample >= autoBrightnessInterval)
   {
-    // Use the six digit display
-    Wire.beginTransmission(IS31FL3730_DIGIT_6_I2C_ADDRESS);
+    unsigned long sampleStart = traceStart();
+    autoBrightnessLastSample = now;
+    updateAutoBrightness();
+    traceSpan(REBOOT_TRACE_AUTO_BRIGHTNESS, 0, sampleStart);
   }
-  else if (displayID == 1)
+#endif
+
+#if REBOOT_ENABLE_GROUPS
+  // Step the group fades
+  for (int groupID = 0; groupID < REBOOT_GROUP_COUNT; groupID++)
   {
-    // Use the smaller four digit display
-    Wire.beginTransmission(IS31FL3730_DIGIT_4S_I2C_ADDRESS);
+    if (groupFadeDuration[groupID] == 0) continue;
+
+    unsigned long elapsed = now - groupFadeStart[groupID];
+    int level = groupFadeTo[groupID];
+
+    if (elapsed >= groupFadeDuration[groupID])
+    {
+      // The fade is done
+      groupFadeDuration[groupID] = 0;
+    }
+    else
+    {
+      level = groupFadeFrom[groupID] +
+        ((long)groupFadeTo[groupID] - groupFadeFrom[groupID]) *
+        (long)elapsed / (long)groupFadeDuration[groupID];
+    }
+
+    // Displays whose brightness did not change are skipped
+    unsigned long stepStart = traceStart();
+    applyGroupBrightness(groupID, level);
+    traceSpan(REBOOT_TRACE_FADE_STEP, groupID, stepStart);
   }
-  else if (displayID == 2)
+#endif
+
+#if REBOOT_ENABLE_SCROLL
+  // Move the message scrolling across the canvas
+  if (scrolling && now - scrollLastStep >= scrollInterval)
   {
-    // Use the four digit display
-    Wire.beginTransmission(IS31FL3730_DIGIT_4_I2C_ADDRESS);
+    unsigned long stepStart = traceStart();
+    scrollLastStep = now;
+    scrollOffset++;
+    drawCanvas(scrollCells, scrollLength, scrollOffset);
+    commitCanvas();
+
+    // The message has scrolled off the left of the canvas
+    if (scrollOffset >= scrollLength)
+    {
+      if (scrollRepeat) scrollOffset = -canvasLength;
+      else scrolling = false;
+    }
+
+    traceSpan(REBOOT_TRACE_SCROLL_STEP, 0, stepStart);
+  }
+#endif
+
+  for (int displayID = 0; displayID < REBOOT_DISPLAY_COUNT; displayID++)
+  {
+#if REBOOT_ENABLE_TRANSITIONS
+    // Step the transition
+    if (transitionMode[displayID] != Transition_None &&
+        now - transitionLastStep[displayID] >= transitionInterval[displayID])
+    {
+      unsigned long stepStart = traceStart();
+      stepTransition(displayID, now);
+      traceSpan(REBOOT_TRACE_TRANSITION_STEP, displayID, stepStart);
+    }
+#endif
+
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+    // Shut down lit displays that have not been updated for a while
+    if (idleTimeout != 0 && displayBlinking(displayID) == false &&
+        transitionRunning(displayID) == false &&
+        displayAsleep[displayID] == false &&
+        displayBlanked[displayID] == false &&
+        now - lastActivity[displayID] >= idleTimeout)
+    {
+      unsigned long idleStart = traceStart();
+      displayAsleep[displayID] = true;
+      beginCurrentChange();
+      applyDisplayShutdown(displayID);
+      endCurrentChange();
+      traceSpan(REBOOT_TRACE_IDLE, displayID, idleStart);
+    }
+#endif
+
+#if REBOOT_ENABLE_BLINK
+    if (blinkPeriod[displayID] == 0) continue;
+
+    // Work out which part of the blink cycle we are in
+    unsigned long phase = (now - blinkStart[displayID]) % blinkPeriod[displayID];
+    bool shutdown = (phase >= blinkOnTime[displayID]);
+
+    // Only touch the display when it actually has to change
+    if (shutdown != displayBlanked[displayID])
+    {
+      unsigned long edgeStart = traceStart();
+      setDisplayShutdown(displayID, shutdown);
+      traceSpan(REBOOT_TRACE_BLINK, displayID, edgeStart);
+    }
+#endif
   }
+
+  traceSpan(REBOOT_TRACE_TICK, 0, tickStart);
+  return nextDeadline();
 }
 
 /*
- * Converts characters into the appropriate bytes for display (gfedcba format)
+ * Puts the microcontroller to sleep for a while, which saves power between
+ * the steps of the effects. Pass it what tick() returned. On AVR boards the
+ * CPU is put into idle sleep, which keeps millis(), the I2C bus, Serial and
+ * the frame clock running, and every interrupt wakes it up for a moment.
+ * Returns early when a frame of the frame clock comes due. Other boards wait
+ * with delay(), and a clock set with setClock() waits with its own delay().
  *
  * Parameters:
- * displayCharacters The character(s) to be converted into a byte for the
- *                   display. Some characters like "W" need multiple digits.
+ * durationMs Longest time to sleep for in milliseconds
  */
-void GhostLab42Reboot::writeCharacter(char displayCharacters[])
+void GhostLab42Reboot::sleep(unsigned long durationMs)
 {
-  // Although this isn't very time efficient (linear time) it's apparently a
-  // very bad idea to use hashmaps on Arduino because they're resource
-  // intensive :-(
+  if (durationMs == 0) return;
 
-  // Sometimes decimals are involved, so we need something to add it
-  byte decimalOffset = 0x00; // No decimal to add
-  if (displayCharacters[1] == '.')
-  {
-    // Add a decimal
-    decimalOffset = 0x80;
-  }
-
-  // Numbers
-  if      (displayCharacters[0] == '0') Wire.write(0x3F + decimalOffset);
-  else if (displayCharacters[0] == '1') Wire.write(0x06 + decimalOffset);
-  else if (displayCharacters[0] == '2') Wire.write(0x5B + decimalOffset);
-  else if (displayCharacters[0] == '3') Wire.write(0x4F + decimalOffset);
-  else if (displayCharacters[0] == '4') Wire.write(0x66 + decimalOffset);
-  else if (displayCharacters[0] == '5') Wire.write(0x6D + decimalOffset);
-  else if (displayCharacters[0] == '6') Wire.write(0x7D + decimalOffset);
-  else if (displayCharacters[0] == '7') Wire.write(0x07 + decimalOffset);
-  else if (displayCharacters[0] == '8') Wire.write(0x7F + decimalOffset);
-  else if (displayCharacters[0] == '9') Wire.write(0x6F + decimalOffset);
-
-  // Letters
-  else if (displayCharacters[0] == 'A' || displayCharacters[0] == 'a') Wire.write(0x77 + decimalOffset);
-  else if (displayCharacters[0] == 'B' || displayCharacters[0] == 'b') Wire.write(0x7C + decimalOffset);
-  else if (displayCharacters[0] == 'C' || displayCharacters[0] == 'c') Wire.write(0x39 + decimalOffset);
-  else if (displayCharacters[0] == 'D' || displayCharacters[0] == 'd') Wire.write(0x5E + decimalOffset);
-  else if (displayCharacters[0] == 'E' || displayCharacters[0] == 'e') Wire.write(0x79 + decimalOffset);
-  else if (displayCharacters[0] == 'F' || displayCharacters[0] == 'f') Wire.write(0x71 + decimalOffset);
-  else if (displayCharacters[0] == 'G' || displayCharacters[0] == 'g') Wire.write(0x3D + decimalOffset);
-  else if (displayCharacters[0] == 'H' || displayCharacters[0] == 'h') Wire.write(0x76 + decimalOffset);
-  else if (displayCharacters[0] == 'I' || displayCharacters[0] == 'i') Wire.write(0x06 + decimalOffset);
-  else if (displayCharacters[0] == 'J' || displayCharacters[0] == 'j') Wire.write(0x1E + decimalOffset);
-  else if (displayCharacters[0] == 'K' || displayCharacters[0] == 'k') Wire.write(0x76 + decimalOffset);
-  else if (displayCharacters[0] == 'L' || displayCharacters[0] == 'l') Wire.write(0x38 + decimalOffset);
-  else if (displayCharacters[0] == 'M' || displayCharacters[0] == 'm')
-  {
-      Wire.write(0x33);
-      Wire.write(0x27 + decimalOffset);
-  }
-  else if (displayCharacters[0] == 'N' || displayCharacters[0] == 'n') Wire.write(0x54 + decimalOffset);
-  else if (displayCharacters[0] == 'O' || displayCharacters[0] == 'o') Wire.write(0x3F + decimalOffset);
-  else if (displayCharacters[0] == 'P' || displayCharacters[0] == 'p') Wire.write(0x73 + decimalOffset);
-  else if (displayCharacters[0] == 'Q' || displayCharacters[0] == 'q') Wire.write(0x67 + decimalOffset);
-  else if (displayCharacters[0] == 'R' || displayCharacters[0] == 'r') Wire.write(0x50 + decimalOffset);
-  else if (displayCharacters[0] == 'S' || displayCharacters[0] == 's') Wire.write(0x6D + decimalOffset);
-  else if (displayCharacters[0] == 'T' || displayCharacters[0] == 't') Wire.write(0x78 + decimalOffset);
-  else if (displayCharacters[0] == 'U' || displayCharacters[0] == 'u') Wire.write(0x3E + decimalOffset);
-  else if (displayCharacters[0] == 'V' || displayCharacters[0] == 'v') Wire.write(0x3E + decimalOffset);
-  else if (displayCharacters[0] == 'W' || displayCharacters[0] == 'w')
-  {
-      Wire.write(0x3C);
-      Wire.write(0x1E + decimalOffset);
-  }
-  else if (displayCharacters[0] == 'X' || displayCharacters[0] == 'x') Wire.write(0x76 + decimalOffset);
-  else if (displayCharacters[0] == 'Y' || displayCharacters[0] == 'y') Wire.write(0x6E + decimalOffset);
-  else if (displayCharacters[0] == 'Z' || displayCharacters[0] == 'z') Wire.write(0x5B + decimalOffset);
-
-  // Symbols
-  else if (displayCharacters[0] == '?') Wire.write(0xA3);
-  else if (displayCharacters[0] == '!') Wire.write(0x82);
-  else if (displayCharacters[0] == '-') Wire.write(0x40);
-  else if (displayCharacters[0] == ' ') Wire.write(0x00 + decimalOffset);
+#if REBOOT_ENABLE_CLOCK
+  // A clock set with setClock() decides how to wait, which lets a test move
+  // its time forward instead
+  if (timeSource != NULL)
+  {
+    timeSource->delay(durationMs);
+    return;
+  }
+#endif
 
-  // Anything else turns into a blank for that character space
-  else Wire.write(0x00);
+#if defined(__AVR__)
+  unsigned long start = millis();
+  set_sleep_mode(SLEEP_MODE_IDLE);
+
+  while (millis() - start < durationMs)
+  {
+    // Check for a frame with interrupts turned off, so one that comes due
+    // right before going to sleep still wakes the CPU up
+    noInterrupts();
+#if REBOOT_FRAME_CLOCK_TIMER > 0
+    if (frameClockPeriod != 0 && frameClockTicks != 0)
+    {
+      interrupts();
+      return;
+    }
+#endif
+    sleep_enable();
+    interrupts();
+    sleep_cpu();
+    sleep_disable();
+  }
+#else
+  delay(durationMs);
+#endif
+}
+
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+/*
+ * Sets how long a display has to go without updates before it is put into
+ * software shutdown to save power. The next update to the display turns it
+ * back on with the content and brightness it had before. Requires tick() to
+ * be called from loop().
+ *
+ * Parameters:
+ * timeoutMs Time without updates in milliseconds, 0 turns the idle timeout off
+ */
+void GhostLab42Reboot::setIdleTimeout(unsigned long timeoutMs)
+{
+  idleTimeout = timeoutMs;
+}
+#endif
+
+/*
+ * Returns how long the display has been in a power state since begin() was
+ * called, which is useful for working out battery life
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * state     One of REBOOT_POWER_ON, REBOOT_POWER_BLANKED or REBOOT_POWER_IDLE
+ */
+unsigned long GhostLab42Reboot::getDisplayPowerTime(int displayID, int state)
+{
+  if (verifyDisplayID(displayID) == false) return 0;
+  if (state < 0 || state >= REBOOT_POWER_STATE_COUNT) return 0;
+
+#if REBOOT_ENABLE_STATISTICS
+  unsigned long time = powerStateTime[displayID][state];
+
+  // Include the time spent in the current state so far
+  if (powerState[displayID] == state)
+  {
+    time += clockMillis() - powerStateSince[displayID];
+  }
+
+  return time;
+#else
+  return 0;
+#endif
+}
+
+#if REBOOT_ENABLE_CURRENT_BUDGET
+/*
+ * Limits how much current all of the displays can draw together. The current
+ * each display draws is estimated from the number of lit segments, its
+ * brightness and its current setting. When the displays would go over the
+ * budget, all of them are dimmed by the same amount, either with a lower
+ * PWM value or by switching to a lower current setting.
+ *
+ * Parameters:
+ * milliamps Current budget in mA, 0 turns the budget off
+ */
+void GhostLab42Reboot::setCurrentBudget(unsigned int milliamps)
+{
+  currentBudget = milliamps;
+
+  beginCurrentChange();
+  endCurrentChange();
+}
+#endif
+
+/*
+ * Returns the estimated current (in mA) drawn by the LEDs of all the displays
+ * together, based on what they are showing right now
+ */
+unsigned int GhostLab42Reboot::getEstimatedCurrent()
+{
+  unsigned long total = 0;
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    if (drawsCurrent(i))
+    {
+      total += estimateCurrent(i, outputPWM[i], displayCurrent[i]);
+    }
+  }
+
+  // Estimates are in uA
+  return (total + 500) / 1000;
+}
+
+/*
+ * Sets the current each segment of the display gets. Lower currents make the
+ * display dimmer and save power, and are more efficient than dimming the
+ * display with setDisplayBrightness(). Only the settings from the current
+ * table that are safe for the displays (5, 10, 15 and 20mA) are accepted.
+ *
+ * Returns true if the current was set, false if it was rejected
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * milliamps Current per segment in mA, 5, 10, 15 or 20
+ */
+bool GhostLab42Reboot::setDisplayCurrent(int displayID, int milliamps)
+{
+  // Verify the display exists before attempting to set its current
+  if (verifyDisplayID(displayID) == false) return false;
+
+  for (byte i = 0; i < IS31FL3730_Current_Setting_Count; i++)
+  {
+    if (readTable(IS31FL3730_Current_Milliamps, i) != milliamps) continue;
+
+    displayMaxCurrent[displayID] = readTable(IS31FL3730_Current_Settings, i);
+
+    // The current budget decides the setting that is actually used, and only
+    // writes it when it changes. Displays that went idle get the new setting
+    // when they wake up.
+    beginCurrentChange();
+    if (displayIdle(displayID) == false)
+    {
+      writeDisplayOutput(displayID, false);
+    }
+    endCurrentChange();
+
+    return true;
+  }
+
+  // Anything above 20mA (or not in the current table) is rejected
+  return false;
+}
+
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+/*
+ * Sets the brightness of all the displays automatically from an analog light
+ * sensor (like a photoresistor in a voltage divider). The sensor is read by
+ * tick(), which needs to be called from loop().
+ *
+ * Readings between darkReading and brightReading are mapped onto the
+ * brightness range, so that darkReading gives minBrightness and brightReading
+ * gives maxBrightness. darkReading can be higher than brightReading for
+ * sensors that read lower values in brighter light.
+ *
+ * Parameters:
+ * pin           Analog pin the sensor is connected to, -1 turns the automatic
+ *               brightness off
+ * darkReading   analogRead() value when it is dark
+ * brightReading analogRead() value in bright light
+ * minBrightness Brightness percentage (0 - 100) in the dark
+ * maxBrightness Brightness percentage (0 - 100) in bright light
+ */
+void GhostLab42Reboot::setAutoBrightness(int pin, int darkReading,
+                                         int brightReading, int minBrightness,
+                                         int maxBrightness)
+{
+  autoBrightnessPin = pin;
+  autoBrightnessDark = darkReading;
+  autoBrightnessBright = brightReading;
+  autoBrightnessMin = constrain(minBrightness, 0, 100);
+  autoBrightnessMax = constrain(maxBrightness, 0, 100);
+
+  // Start the filter over with the next reading, and make sure the first
+  // reading is applied right away
+  autoBrightnessPrimed = false;
+  autoBrightnessLastSample = clockMillis() - autoBrightnessInterval;
+}
+
+/*
+ * Sets how the light sensor readings are filtered, so that the brightness does
+ * not flicker with small changes in light and the displays are not written to
+ * more than needed
+ *
+ * Parameters:
+ * sampleIntervalMs Time between sensor readings in milliseconds
+ * samples          Number of analogRead() calls that are averaged for each
+ *                  reading (1 - 64)
+ * smoothing        Exponential smoothing of the readings (0 - 7). Each new
+ *                  reading moves the filtered value 1/2^smoothing of the way,
+ *                  so 0 turns smoothing off.
+ * threshold        How much the PWM register value (0 - 128) has to change
+ *                  before it is written to the displays
+ */
+void GhostLab42Reboot::setAutoBrightnessFilter(unsigned long sampleIntervalMs,
+                                               int samples, int smoothing,
+                                               int threshold)
+{
+  autoBrightnessInterval = sampleIntervalMs;
+  autoBrightnessSamples = constrain(samples, 1, 64);
+  autoBrightnessSmoothing = constrain(smoothing, 0, 7);
+  autoBrightnessThreshold = constrain(threshold, 1, 128);
+}
+#endif
+
+#if REBOOT_ENABLE_GROUPS
+/*
+ * Adds a display to a brightness group, or changes its scale if it is already
+ * a member. The brightness of all the displays in a group is set with a single
+ * setGroupBrightness() call, and each display gets its scale percentage of the
+ * group brightness.
+ *
+ * Parameters:
+ * groupID   Unique identifier for the group (0 - REBOOT_GROUP_COUNT - 1)
+ * displayID Unique identifier for the display
+ * scale     Percentage (0 - 100) of the group brightness the display gets
+ */
+void GhostLab42Reboot::setBrightnessGroup(int groupID, int displayID,
+                                          int scale)
+{
+  // Verify the group and display exist before attempting to change the group
+  if (verifyGroupID(groupID) == false) return;
+  if (verifyDisplayID(displayID) == false) return;
+
+  groupMembers[groupID] |= (1 << displayID);
+  groupScale[groupID][displayID] = constrain(scale, 0, 100);
+}
+
+/*
+ * Removes a display from a brightness group. The display keeps the brightness
+ * it has.
+ *
+ * Parameters:
+ * groupID   Unique identifier for the group (0 - REBOOT_GROUP_COUNT - 1)
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::removeFromBrightnessGroup(int groupID, int displayID)
+{
+  // Verify the group and display exist before attempting to change the group
+  if (verifyGroupID(groupID) == false) return;
+  if (verifyDisplayID(displayID) == false) return;
+
+  groupMembers[groupID] &= ~(1 << displayID);
+}
+
+/*
+ * Sets the brightness of all the displays in a group at once. The PWM
+ * registers of the displays are written back to back, and displays whose
+ * brightness did not change are skipped. Stops the group fade if there is one.
+ *
+ * Parameters:
+ * groupID    Unique identifier for the group (0 - REBOOT_GROUP_COUNT - 1)
+ * brightness The dimming level percentage as an int 0 - 100.
+ */
+void GhostLab42Reboot::setGroupBrightness(int groupID, int brightness)
+{
+  // Verify the group exists before attempting to set its brightness
+  if (verifyGroupID(groupID) == false) return;
+
+  groupFadeDuration[groupID] = 0;
+  applyGroupBrightness(groupID, brightness);
+}
+
+/*
+ * Fades the brightness of all the displays in a group from the current group
+ * brightness to a new one. The fade is driven by tick(), which needs to be
+ * called regularly from loop().
+ *
+ * Parameters:
+ * groupID    Unique identifier for the group (0 - REBOOT_GROUP_COUNT - 1)
+ * brightness The dimming level percentage (0 - 100) at the end of the fade
+ * durationMs Length of the fade in milliseconds
+ */
+void GhostLab42Reboot::fadeGroupBrightness(int groupID, int brightness,
+                                           unsigned long durationMs)
+{
+  // Verify the group exists before attempting to fade it
+  if (verifyGroupID(groupID) == false) return;
+
+  brightness = constrain(brightness, 0, 100);
+
+  // Nothing to fade, just set the brightness
+  if (durationMs == 0)
+  {
+    setGroupBrightness(groupID, brightness);
+    return;
+  }
+
+  groupFadeFrom[groupID] = groupLevel[groupID];
+  groupFadeTo[groupID] = brightness;
+  groupFadeStart[groupID] = clockMillis();
+  groupFadeDuration[groupID] = durationMs;
+}
+#endif
+
+#if REBOOT_ENABLE_TRANSITIONS
+/*
+ * Writes the characters to the display, fading out what the display was
+ * showing while the new characters fade in. The frames are blended by quickly
+ * switching between them, showing the new frame more and more often. The
+ * crossfade is driven by tick(), which needs to be called regularly from
+ * loop().
+ *
+ * If the bus budget (see setCrossfadeOptions()) does not allow switching
+ * quickly enough to blend the frames, the display is faded out, switched to
+ * the new frame and faded back in instead.
+ *
+ * Parameters:
+ * displayID  Unique identifier for the display
+ * value      String with the value that you would like to display
+ * durationMs Length of the crossfade in milliseconds
+ */
+void GhostLab42Reboot::crossfade(int displayID, String value,
+                                 unsigned long durationMs)
+{
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return;
+
+  if (beginTransition(displayID, value, durationMs, Transition_Crossfade) ==
+      false)
+  {
+    return;
+  }
+
+  // Switching frames writes the current setting and the Update Column
+  // Register (address, register index and value each) and the digits
+  // (address, register index and data)
+  unsigned int switchBytes = transitionColumnCount[displayID] + 8;
+  unsigned long subframes = durationMs / crossfadeSubframe;
+  if (subframes == 0) subframes = 1;
+
+  transitionInterval[displayID] = crossfadeSubframe;
+
+  // Worst case the frame switches on every sub-frame, so stretch the
+  // sub-frames to stay within the bus budget
+  if (crossfadeBusBudget != 0 && subframes * switchBytes > crossfadeBusBudget)
+  {
+    subframes = crossfadeBusBudget / switchBytes;
+    if (subframes == 0) subframes = 1;
+    transitionInterval[displayID] = durationMs / subframes;
+
+    // Too slow to blend the frames without flicker, so fade out and back in
+    // with the PWM register instead (3 bytes per step, plus one frame switch)
+    if (transitionInterval[displayID] > Crossfade_Max_Subframe)
+    {
+      unsigned long steps = 2;
+      if (crossfadeBusBudget > switchBytes + 6)
+      {
+        steps = (crossfadeBusBudget - switchBytes) / 3;
+      }
+      if (steps > durationMs / crossfadeSubframe)
+      {
+        steps = durationMs / crossfadeSubframe;
+      }
+      if (steps < 2) steps = 2;
+
+      transitionMode[displayID] = Transition_Dip;
+      transitionInterval[displayID] = durationMs / steps;
+    }
+  }
+}
+
+/*
+ * Writes the characters to the display with a segment transition from what the
+ * display was showing. The transition is worked out when it starts, as a short
+ * list of the digits that change in each step, so each step only sends those
+ * digits. The transition is driven by tick(), which needs to be called
+ * regularly from loop().
+ *
+ * Parameters:
+ * displayID  Unique identifier for the display
+ * value      String with the value that you would like to display
+ * effect     REBOOT_WIPE_LEFT_TO_RIGHT, REBOOT_WIPE_TOP_DOWN, REBOOT_DISSOLVE or
+ *            REBOOT_MORPH
+ * durationMs Length of the transition in milliseconds
+ */
+void GhostLab42Reboot::transition(int displayID, String value, int effect,
+                                  unsigned long durationMs)
+{
+  // Verify the display exists before attempting to write to it
+  if (verifyDisplayID(displayID) == false) return;
+
+  if (beginTransition(displayID, value, durationMs, Transition_Segments) ==
+      false)
+  {
+    return;
+  }
+
+  // Every step of the transition is made from the old and new frames, and
+  // only the digits that differ from the step before are kept
+  byte previous[REBOOT_MAX_DIGITS];
+  memcpy(previous, transitionFrom[displayID], sizeof(previous));
+
+  byte digits = digitCount(displayID);
+  byte steps = segmentTransitionSteps(displayID, effect);
+  byte count = 0;
+
+  for (byte step = 1; step <= steps; step++)
+  {
+    // Jump straight to the new frame if the rest of the steps might not fit
+    if (REBOOT_TRANSITION_DELTAS - count < 2 * digits) step = steps;
+
+    byte stepStart = count;
+    for (byte column = 0; column < digits; column++)
+    {
+      byte segments = segmentTransitionFrame(displayID, effect, column, step,
+                                             steps);
+      if (segments == previous[column]) continue;
+
+      previous[column] = segments;
+      transitionDeltas[displayID][count][0] = column;
+      transitionDeltas[displayID][count][1] = segments;
+      count++;
+    }
+
+    // Mark the end of the step (steps that change nothing are left out)
+    if (count > stepStart) transitionDeltas[displayID][count - 1][0] |= 0x80;
+  }
+
+  // Spread the steps that were kept over the duration
+  byte kept = 0;
+  for (byte i = 0; i < count; i++)
+  {
+    if (transitionDeltas[displayID][i][0] & 0x80) kept++;
+  }
+
+  transitionDeltaCount[displayID] = count;
+  transitionDeltaIndex[displayID] = 0;
+  transitionInterval[displayID] = durationMs / (kept + 1);
+}
+
+/*
+ * Sets how crossfades switch between frames
+ *
+ * Parameters:
+ * subframeMs Time each frame is shown for before switching (1 - 20ms), lower
+ *            values blend the frames more smoothly but use the bus more
+ * busBudget  Most bytes a single crossfade can send over the I2C bus, 0 for
+ *            no limit
+ */
+void GhostLab42Reboot::setCrossfadeOptions(unsigned long subframeMs,
+                                           unsigned int busBudget)
+{
+  crossfadeSubframe = constrain(subframeMs, 1, Crossfade_Max_Subframe);
+  crossfadeBusBudget = busBudget;
+}
+
+/*
+ * Returns the number of bytes sent over the I2C bus by the transition that is
+ * running on the display, or by the last one if none is running
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+unsigned long GhostLab42Reboot::getTransitionBusBytes(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return 0;
+#if REBOOT_ENABLE_STATISTICS
+  return transitionBytes[displayID];
+#else
+  return 0;
+#endif
+}
+
+/*
+ * Returns the number of I2C transactions used by the transition that is
+ * running on the display, or by the last one if none is running
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+unsigned long GhostLab42Reboot::getTransitionBusTransactions(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return 0;
+#if REBOOT_ENABLE_STATISTICS
+  return transitionTransactions[displayID];
+#else
+  return 0;
+#endif
+}
+#endif
+
+#if REBOOT_ENABLE_CANVAS
+/*
+ * Sets which displays make up the canvas and in what order, from left to
+ * right. Use -1 for a place that should not have a display, for example
+ * setCanvasOrder(2, 0, -1) puts display 2 in front of display 0 and leaves
+ * display 1 off the canvas. The default order is 0, 1, 2. An order that
+ * names a display that does not exist or names a display twice is ignored.
+ *
+ * Parameters:
+ * first  Unique identifier for the leftmost display, or -1
+ * second Unique identifier for the middle display, or -1
+ * third  Unique identifier for the rightmost display, or -1
+ */
+void GhostLab42Reboot::setCanvasOrder(int first, int second, int third)
+{
+  int order[REBOOT_DISPLAY_COUNT] = { first, second, third };
+  byte length = 0;
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    if (order[i] == -1) continue;
+    if (verifyDisplayID(order[i]) == false) return;
+
+    for (int j = 0; j < i; j++)
+    {
+      if (order[j] == order[i]) return;
+    }
+
+    length += digitCount(order[i]);
+  }
+
+#if REBOOT_ENABLE_SCROLL
+  scrolling = false;
+#endif
+  canvasLength = length;
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    canvasOrder[i] = order[i];
+  }
+}
+
+/*
+ * Writes the characters across all of the displays on the canvas as if they
+ * were one long display. Digits that are not filled are blanked. Only the
+ * digits that changed are sent, and displays that did not change at all are
+ * not written to.
+ *
+ * Parameters:
+ * value     String with the value that you would like to display
+ * alignment REBOOT_ALIGN_LEFT, REBOOT_ALIGN_RIGHT or REBOOT_ALIGN_CENTER
+ * overflow  REBOOT_OVERFLOW_TRUNCATE or REBOOT_OVERFLOW_ELLIPSIS
+ */
+void GhostLab42Reboot::writeCanvas(String value, int alignment, int overflow)
+{
+  byte cells[REBOOT_DISPLAY_COUNT * REBOOT_MAX_DIGITS];
+  layoutCells(currentCanvasFont(), value.c_str(), cells, canvasLength,
+              alignment, overflow);
+
+#if REBOOT_ENABLE_SCROLL
+  scrolling = false;
+#endif
+  drawCanvas(cells, canvasLength, 0);
+  commitCanvas();
+}
+#endif
+
+#if REBOOT_ENABLE_SCROLL
+/*
+ * Scrolls the characters across the canvas from right to left, one digit per
+ * step. The message is converted to segment data once, when the scroll starts,
+ * and is cut off after REBOOT_SCROLL_CELLS digits. The scroll is driven by
+ * tick(), which needs to be called regularly from loop(). Writing to the
+ * canvas or changing its order stops the scroll.
+ *
+ * Returns the number of digits that were kept, which is less than the width of
+ * the message if it was cut off
+ *
+ * Parameters:
+ * value  String with the message that you would like to scroll
+ * stepMs Time each step is shown in milliseconds
+ * repeat Start over once the message has scrolled off, instead of stopping
+ */
+int GhostLab42Reboot::scrollCanvas(String value, unsigned long stepMs,
+                                   bool repeat)
+{
+  scrollLength = encodeCells(currentCanvasFont(), value.c_str(), scrollCells,
+                             REBOOT_SCROLL_CELLS, 0);
+  if (scrollLength > REBOOT_SCROLL_CELLS) scrollLength = REBOOT_SCROLL_CELLS;
+  scrollRepeat = repeat;
+  scrollInterval = stepMs;
+  scrollLastStep = clockMillis();
+
+  // Start with the first character coming in on the right
+  scrollOffset = 1 - canvasLength;
+  scrolling = true;
+  drawCanvas(scrollCells, scrollLength, scrollOffset);
+  commitCanvas();
+  return scrollLength;
+}
+
+/*
+ * Returns whether a message is scrolling across the canvas
+ */
+bool GhostLab42Reboot::isCanvasScrolling()
+{
+  return scrolling;
+}
+#endif
+
+#if REBOOT_ENABLE_ORIENTATION
+/*
+ * Sets how the display is mounted. Turning a display upside down or mirroring
+ * it left to right also reverses the order of its digits. The segment map is
+ * looked up when characters are converted, so this costs nothing per write.
+ * The display is cleared, so set the orientation before writing to it.
+ *
+ * Parameters:
+ * displayID   Unique identifier for the display
+ * orientation REBOOT_ORIENTATION_NORMAL, REBOOT_ROTATE_180,
+ *             REBOOT_MIRROR_HORIZONTAL or REBOOT_MIRROR_VERTICAL
+ */
+void GhostLab42Reboot::setDisplayOrientation(int displayID, int orientation)
+{
+  if (verifyDisplayID(displayID) == false) return;
+
+  if (orientation == REBOOT_ORIENTATION_NORMAL)
+  {
+    segmentMap[displayID] = NULL;
+    reverseColumns[displayID] = false;
+  }
+  else if (orientation == REBOOT_ROTATE_180)
+  {
+    segmentMap[displayID] = Segment_Map_Rotate_180;
+    reverseColumns[displayID] = true;
+  }
+  else if (orientation == REBOOT_MIRROR_HORIZONTAL)
+  {
+    segmentMap[displayID] = Segment_Map_Mirror_Horizontal;
+    reverseColumns[displayID] = true;
+  }
+  else if (orientation == REBOOT_MIRROR_VERTICAL)
+  {
+    segmentMap[displayID] = Segment_Map_Mirror_Vertical;
+    reverseColumns[displayID] = false;
+  }
+  else
+  {
+    return;
+  }
+
+  clearFrame(displayID);
+}
+
+/*
+ * Sets the segment map of a display with a different wiring than the gfedcba
+ * layout, for example a custom IS31FL3730 board. The map has 256 bytes in
+ * flash (PROGMEM), made with REBOOT_SEGMENT_MAP(), and replaces the segment
+ * map of the orientation (the digit order of the orientation is kept). The
+ * display is cleared, so set the segment map before writing to it.
+ *
+ * Parameters:
+ * displayID    Unique identifier for the display
+ * segmentTable Segment map in flash, or NULL for the gfedcba layout
+ */
+void GhostLab42Reboot::setSegmentMap(int displayID,
+                                     const byte *segmentTable)
+{
+  if (verifyDisplayID(displayID) == false) return;
+
+  segmentMap[displayID] = segmentTable;
+  clearFrame(displayID);
+}
+#endif
+
+#if REBOOT_ENABLE_FONTS
+/*
+ * Sets the font the display converts characters with, from the next write on.
+ * Fonts are stored in flash, so switching fonts costs no memory and looking up
+ * a character takes as long as with the default font.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * font      Font to use, or NULL for the default font
+ */
+void GhostLab42Reboot::setDisplayFont(int displayID, const RebootFont *font)
+{
+  if (verifyDisplayID(displayID) == false) return;
+
+  displayFont[displayID] = (font == NULL) ? &rebootDefaultFont : font;
+}
+
+#if REBOOT_ENABLE_CANVAS
+/*
+ * Sets the font the canvas converts characters with, from the next write or
+ * scroll on
+ *
+ * Parameters:
+ * font Font to use, or NULL for the default font
+ */
+void GhostLab42Reboot::setCanvasFont(const RebootFont *font)
+{
+  canvasFont = (font == NULL) ? &rebootDefaultFont : font;
+}
+#endif
+#endif
+
+#if REBOOT_MIRROR_COUNT > 0
+/*
+ * Adds a board that shows a copy of one of the displays, for example a
+ * duplicate board set on another channel of an I2C multiplexer. Everything the
+ * display is sent (segments, brightness, blanking and current) is copied to
+ * the board. Returns false if the board could not be added.
+ *
+ * Parameters:
+ * displayID  Unique identifier for the display to copy
+ * address    I2C address of the board
+ * muxChannel Channel of the I2C multiplexer the board is on (0-7), or -1 if
+ *            the board is not behind the multiplexer
+ */
+bool GhostLab42Reboot::addMirror(int displayID, byte address, int muxChannel)
+{
+  if (verifyDisplayID(displayID) == false) return false;
+  if (muxChannel < -1 || muxChannel >= TCA9548A_Channel_Count) return false;
+  if (mirrorCount == REBOOT_MIRROR_COUNT) return false;
+
+  // Only one board can answer to an address on each channel, and the
+  // displays are on the main bus
+  if (muxChannel == -1 &&
+      (address == IS31FL3730_DIGIT_6_I2C_ADDRESS ||
+       address == IS31FL3730_DIGIT_4S_I2C_ADDRESS ||
+       address == IS31FL3730_DIGIT_4_I2C_ADDRESS))
+  {
+    return false;
+  }
+
+  for (byte i = 0; i < mirrorCount; i++)
+  {
+    if (mirrorAddress[i] == address && mirrorChannel[i] == muxChannel)
+    {
+      return false;
+    }
+  }
+
+  // Keep the mirrors sorted by channel, so that updating them switches the
+  // multiplexer as few times as possible
+  byte mirror = mirrorCount;
+  while (mirror > 0 && mirrorChannel[mirror - 1] > muxChannel)
+  {
+    mirrorSource[mirror] = mirrorSource[mirror - 1];
+    mirrorAddress[mirror] = mirrorAddress[mirror - 1];
+    mirrorChannel[mirror] = mirrorChannel[mirror - 1];
+    memcpy(mirrorData[mirror], mirrorData[mirror - 1],
+           sizeof(mirrorData[mirror]));
+    mirrorPWM[mirror] = mirrorPWM[mirror - 1];
+    mirrorConfig[mirror] = mirrorConfig[mirror - 1];
+    mirrorCurrent[mirror] = mirrorCurrent[mirror - 1];
+    mirrorKnown[mirror] = mirrorKnown[mirror - 1];
+    mirror--;
+  }
+
+  mirrorSource[mirror] = displayID;
+  mirrorAddress[mirror] = address;
+  mirrorChannel[mirror] = muxChannel;
+  mirrorKnown[mirror] = false;
+  mirrorCount++;
+
+  // Nothing is known about what the board shows, so send it everything
+  syncMirror(mirror, true);
+
+  return true;
+}
+
+/*
+ * Stops copying the display to the boards that were added with addMirror().
+ * The boards keep showing what they were showing.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::removeMirrors(int displayID)
+{
+  if (verifyDisplayID(displayID) == false) return;
+
+  byte count = 0;
+
+  for (byte i = 0; i < mirrorCount; i++)
+  {
+    if (mirrorSource[i] == displayID) continue;
+
+    mirrorSource[count] = mirrorSource[i];
+    mirrorAddress[count] = mirrorAddress[i];
+    mirrorChannel[count] = mirrorChannel[i];
+    memcpy(mirrorData[count], mirrorData[i], sizeof(mirrorData[count]));
+    mirrorPWM[count] = mirrorPWM[i];
+    mirrorConfig[count] = mirrorConfig[i];
+    mirrorCurrent[count] = mirrorCurrent[i];
+    mirrorKnown[count] = mirrorKnown[i];
+    count++;
+  }
+
+  mirrorCount = count;
+}
+
+/*
+ * Sets the I2C address of the multiplexer the mirrors are behind. The
+ * default is 0x70.
+ *
+ * Parameters:
+ * address I2C address of the multiplexer
+ */
+void GhostLab42Reboot::setMuxAddress(byte address)
+{
+  muxAddress = address;
+  muxSelected = -1;
+}
+#endif
+
+/*
+ * Prints the spans in the trace, oldest first, and empties the trace. Every
+ * line is comma separated: a "trace" line with the number of spans and the
+ * number of spans that were overwritten since the last dump, then a "span"
+ * line for each span with its kind, ID, start (from micros()) and length in
+ * microseconds. extras/trace/reboot_trace.py turns the lines into a Chrome
+ * trace. Only prints the "trace" line when tracing is turned off.
+ *
+ * Parameters:
+ * out Where to print the spans, like Serial
+ */
+void GhostLab42Reboot::dumpTrace(Print &out)
+{
+#if REBOOT_TRACE_SPANS > 0
+  // Take the spans out of the ring first, so the transactions of out (if it
+  // is on the I2C bus) do not end up in it
+  unsigned int count = traceCount;
+  unsigned int first = (traceNext + REBOOT_TRACE_SPANS - count) %
+                       REBOOT_TRACE_SPANS;
+  unsigned long dropped = traceDropped;
+  traceCount = 0;
+  traceDropped = 0;
+#else
+  unsigned int count = 0;
+  unsigned long dropped = 0;
+#endif
+
+  out.print(F("trace,"));
+  out.print(count);
+  out.print(',');
+  out.println(dropped);
+
+#if REBOOT_TRACE_SPANS > 0
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const RebootTraceSpan &span = traceSpans[(first + i) % REBOOT_TRACE_SPANS];
+
+    out.print(F("span,"));
+    switch (span.kind)
+    {
+      case REBOOT_TRACE_TRANSACTION:     out.print(F("transaction")); break;
+      case REBOOT_TRACE_COMMIT:          out.print(F("commit")); break;
+      case REBOOT_TRACE_TICK:            out.print(F("tick")); break;
+      case REBOOT_TRACE_TRANSITION_STEP: out.print(F("transition")); break;
+      case REBOOT_TRACE_FADE_STEP:       out.print(F("fade")); break;
+      case REBOOT_TRACE_SCROLL_STEP:     out.print(F("scroll")); break;
+      case REBOOT_TRACE_FRAME:           out.print(F("frame")); break;
+      case REBOOT_TRACE_BLINK:           out.print(F("blink")); break;
+      case REBOOT_TRACE_IDLE:            out.print(F("idle")); break;
+      case REBOOT_TRACE_AUTO_BRIGHTNESS: out.print(F("light")); break;
+    }
+    out.print(',');
+    out.print(span.id);
+    out.print(',');
+    out.print(span.start);
+    out.print(',');
+    out.println(span.duration);
+  }
+#endif
+}
+
+#if REBOOT_ENABLE_CLOCK
+/*
+ * Sets the clock that the time based effects, the scheduling of tick(), the
+ * trace and the frame clock (without a hardware timer) read the time from.
+ * A test on a computer can set a RebootManualClock and move time forward
+ * instantly. NULL goes back to millis() and micros().
+ *
+ * Parameters:
+ * clock Clock to read the time from, or NULL
+ */
+void GhostLab42Reboot::setClock(RebootClock *clock)
+{
+  timeSource = clock;
+}
+#endif
+
+#if REBOOT_FRAME_CLOCK > 0
+/*
+ * Starts the frame clock, which makes isFrameDue() return true once every
+ * period. On AVR boards the frames are timed by the hardware timer chosen
+ * with REBOOT_FRAME_CLOCK, so they come due at a steady rate however long
+ * the loop takes. Returns false if the timer cannot count the period.
+ *
+ * Parameters:
+ * periodUs Time between frames in microseconds
+ */
+bool GhostLab42Reboot::startFrameClock(unsigned long periodUs)
+{
+  if (periodUs == 0) return false;
+
+#if REBOOT_FRAME_CLOCK_TIMER == 1
+  // Use the smallest prescaler the period fits in the 16 bit compare
+  // register with, for the finest steps
+  if (periodUs > 0xFFFFFFFFUL / (F_CPU / 1000000UL)) return false;
+
+  const unsigned int prescalers[] = {1, 8, 64, 256, 1024};
+  unsigned long cycles = (F_CPU / 1000000UL) * periodUs;
+  byte clockSelect = 0;
+  unsigned long compare = 0;
+
+  for (byte i = 0; i < 5 && clockSelect == 0; i++)
+  {
+    if (cycles / prescalers[i] <= 65536UL)
+    {
+      clockSelect = i + 1;
+      compare = cycles / prescalers[i] - 1;
+    }
+  }
+
+  if (clockSelect == 0) return false;
+
+  noInterrupts();
+  TCCR1A = 0;
+  TCCR1B = (1 << WGM12) | clockSelect;
+  TCNT1 = 0;
+  OCR1A = compare;
+  TIFR1 = (1 << OCF1A);
+  TIMSK1 |= (1 << OCIE1A);
+  frameClockTicks = 0;
+  frameClockTime = micros();
+  interrupts();
+#elif REBOOT_FRAME_CLOCK_TIMER == 2
+  // Interrupt every millisecond, with the smallest prescaler that fits a
+  // millisecond in the 8 bit compare register
+  const unsigned int prescalers[] = {1, 8, 32, 64, 128, 256, 1024};
+  unsigned long cycles = F_CPU / 1000UL;
+  byte clockSelect = 0;
+  byte compare = 0;
+
+  for (byte i = 0; i < 7 && clockSelect == 0; i++)
+  {
+    if (cycles / prescalers[i] <= 256)
+    {
+      clockSelect = i + 1;
+      compare = cycles / prescalers[i] - 1;
+    }
+  }
+
+  unsigned long periodMs = (periodUs + 500) / 1000;
+  if (periodMs == 0) periodMs = 1;
+  if (clockSelect == 0 || periodMs > 0xFFFF) return false;
+  periodUs = periodMs * 1000;
+
+  noInterrupts();
+  TCCR2A = (1 << WGM21);
+  TCCR2B = clockSelect;
+  TCNT2 = 0;
+  OCR2A = compare;
+  TIFR2 = (1 << OCF2A);
+  TIMSK2 |= (1 << OCIE2A);
+  frameClockMs = periodMs;
+  frameClockCountdown = periodMs;
+  frameClockTicks = 0;
+  frameClockTime = micros();
+  interrupts();
+#else
+  frameClockNext = clockMicros() + periodUs;
+#endif
+
+  frameClockPeriod = periodUs;
+  missedFrames = 0;
+  return true;
+}
+
+/*
+ * Stops the frame clock and frees its timer
+ */
+void GhostLab42Reboot::stopFrameClock()
+{
+#if REBOOT_FRAME_CLOCK_TIMER == 1
+  noInterrupts();
+  TIMSK1 &= ~(1 << OCIE1A);
+  TCCR1B = 0;
+  frameClockTicks = 0;
+  interrupts();
+#elif REBOOT_FRAME_CLOCK_TIMER == 2
+  noInterrupts();
+  TIMSK2 &= ~(1 << OCIE2A);
+  TCCR2B = 0;
+  frameClockTicks = 0;
+  interrupts();
+#endif
+
+  frameClockPeriod = 0;
+}
+
+/*
+ * Returns true once for every frame of the frame clock that came due, so the
+ * loop can draw the next frame. Frames that came due while the last one was
+ * still being drawn are skipped and counted by getMissedFrames(), so the
+ * animation keeps its pace instead of rushing to catch up. Records a frame
+ * span in the trace from when the frame came due until now.
+ */
+bool GhostLab42Reboot::isFrameDue()
+{
+  if (frameClockPeriod == 0) return false;
+
+#if REBOOT_FRAME_CLOCK_TIMER > 0
+  noInterrupts();
+  byte ticks = frameClockTicks;
+  unsigned long due = frameClockTime;
+  frameClockTicks = 0;
+  interrupts();
+
+  if (ticks == 0) return false;
+  unsigned long skipped = ticks - 1;
+#else
+  unsigned long now = clockMicros();
+  if ((long)(now - frameClockNext) < 0) return false;
+
+  // Move on to the last frame that came due, keeping to the period so the
+  // frames do not drift
+  unsigned long skipped = (now - frameClockNext) / frameClockPeriod;
+  unsigned long due = frameClockNext + skipped * frameClockPeriod;
+  frameClockNext = due + frameClockPeriod;
+#endif
+
+  missedFrames += skipped;
+  traceSpan(REBOOT_TRACE_FRAME, (skipped > 255) ? 255 : skipped, due);
+  return true;
+}
+
+/*
+ * Returns the number of frames of the frame clock that were skipped since it
+ * was started, because the loop did not check isFrameDue() in time
+ */
+unsigned long GhostLab42Reboot::getMissedFrames()
+{
+  return missedFrames;
+}
+#endif
+
+/******************************************************************************
+ *                             Private Functions                              *
+ ******************************************************************************/
+
+/*
+ * Makes sure the user passes the library a valid display ID
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::verifyDisplayID(int displayID)
+{
+  // User can technically give us any ID
+  // If they give us a bad ID, return false
+  return (displayID >= 0 && displayID < REBOOT_DISPLAY_COUNT);
+}
+
+/*
+ * Returns the milliseconds from the clock set with setClock(), or millis()
+ */
+unsigned long GhostLab42Reboot::clockMillis()
+{
+#if REBOOT_ENABLE_CLOCK
+  if (timeSource != NULL) return timeSource->millis();
+#endif
+  return millis();
+}
+
+/*
+ * Returns the microseconds from the clock set with setClock(), or micros()
+ */
+unsigned long GhostLab42Reboot::clockMicros()
+{
+#if REBOOT_ENABLE_CLOCK
+  if (timeSource != NULL) return timeSource->micros();
+#endif
+  return micros();
+}
+
+#if REBOOT_ENABLE_GROUPS
+/*
+ * Makes sure the user passes the library a valid brightness group ID
+ *
+ * Parameters:
+ * groupID Unique identifier for the group
+ */
+bool GhostLab42Reboot::verifyGroupID(int groupID)
+{
+  return (groupID >= 0 && groupID < REBOOT_GROUP_COUNT);
+}
+
+/*
+ * Sets the group brightness and writes the PWM registers of the members whose
+ * brightness changed, one after the other
+ *
+ * Parameters:
+ * groupID    Unique identifier for the group
+ * brightness The dimming level percentage as an int 0 - 100.
+ */
+void GhostLab42Reboot::applyGroupBrightness(int groupID, int brightness)
+{
+  groupLevel[groupID] = constrain(brightness, 0, 100);
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    if ((groupMembers[groupID] & (1 << i)) == 0) continue;
+
+    int level = (int)groupLevel[groupID] * groupScale[groupID][i] / 100;
+    displayPWM[i] = readTable(lightCorrectionTable, level);
+  }
+
+  // The PWM registers are only written for displays whose value changed.
+  // Displays that went idle get the new brightness when they wake up.
+  beginCurrentChange();
+  endCurrentChange();
+}
+#endif
+
+/*
+ * Sets or clears the software shutdown bit of the display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * shutdown  True to turn the display off, false to turn it back on
+ */
+void GhostLab42Reboot::setDisplayShutdown(int displayID, bool shutdown)
+{
+  displayBlanked[displayID] = shutdown;
+
+  beginCurrentChange();
+
+  // A display that turns on gets its share of the current budget first
+  if (shutdown == false) writeDisplayOutput(displayID, false);
+
+  applyDisplayShutdown(displayID);
+  endCurrentChange();
+}
+
+/*
+ * Writes the software shutdown bit of the display. The display is shut down
+ * when it is blanked or when it went idle.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::applyDisplayShutdown(int displayID)
+{
+  bool shutdown = displayBlanked[displayID] || displayIdle(displayID);
+
+  writeRegister(displayID, IS31FL3730_Configuration_Register,
+                shutdown ? IS31FL3730_Configuration_Shutdown
+                         : IS31FL3730_Configuration_Normal);
+
+  updatePowerState(displayID);
+}
+
+/*
+ * Adds the time spent in the previous power state to its total when the
+ * display changes power state
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::updatePowerState(int displayID)
+{
+#if REBOOT_ENABLE_STATISTICS
+  byte state = REBOOT_POWER_ON;
+  if (displayIdle(displayID)) state = REBOOT_POWER_IDLE;
+  else if (displayBlanked[displayID]) state = REBOOT_POWER_BLANKED;
+
+  if (state == powerState[displayID]) return;
+
+  unsigned long now = clockMillis();
+  powerStateTime[displayID][powerState[displayID]] +=
+    now - powerStateSince[displayID];
+  powerStateSince[displayID] = now;
+  powerState[displayID] = state;
+#endif
+}
+
+/*
+ * Restarts the idle timeout of the display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::markActivity(int displayID)
+{
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+  lastActivity[displayID] = clockMillis();
+#endif
+}
+
+/*
+ * Turns a display that went idle back on. Everything is restored from the
+ * frame buffer and the cached brightness while the display is still shut
+ * down, so there is no flash of old or half written content.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::wakeDisplay(int displayID)
+{
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+  if (displayAsleep[displayID] == false) return;
+
+  displayAsleep[displayID] = false;
+
+  // Make room in the current budget before the display turns back on
+  beginCurrentChange();
+
+  // Restore the brightness and make sure the maximum current for the display
+  // is not exceeded
+  writeDisplayOutput(displayID, true);
+  sendFrame(displayID, 0, digitCount(displayID));
+  clearDirty(displayID);
+
+  // Turn the display back on (unless it was blanked in the meantime)
+  applyDisplayShutdown(displayID);
+
+  endCurrentChange();
+#endif
+}
+
+/*
+ * Returns true if the display was shut down by the idle timeout, which is
+ * never the case when the idle timeout is left out of the library
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::displayIdle(int displayID)
+{
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+  return displayAsleep[displayID];
+#else
+  return false;
+#endif
+}
+
+/*
+ * Returns true if the display is blinking, which is never the case when
+ * blink() is left out of the library
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::displayBlinking(int displayID)
+{
+#if REBOOT_ENABLE_BLINK
+  return blinkPeriod[displayID] != 0;
+#else
+  return false;
+#endif
+}
+
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+/*
+ * Reads the light sensor and changes the brightness of the displays when the
+ * filtered reading moved far enough
+ */
+void GhostLab42Reboot::updateAutoBrightness()
+{
+  // Average a few readings to get rid of noise
+  long reading = 0;
+  for (byte i = 0; i < autoBrightnessSamples; i++)
+  {
+    reading += analogRead(autoBrightnessPin);
+  }
+  reading /= autoBrightnessSamples;
+
+  // Exponential smoothing, kept with 4 extra bits so small changes still
+  // add up over time
+  reading *= 16;
+  bool firstReading = (autoBrightnessPrimed == false);
+  if (firstReading)
+  {
+    autoBrightnessFiltered = reading;
+    autoBrightnessPrimed = true;
+  }
+  else
+  {
+    autoBrightnessFiltered +=
+      (reading - autoBrightnessFiltered) / (1 << autoBrightnessSmoothing);
+  }
+
+  // Map the reading onto the brightness range, and then onto the light
+  // correction lookup table
+  long brightness = autoBrightnessMax;
+  if (autoBrightnessDark != autoBrightnessBright)
+  {
+    brightness = map(autoBrightnessFiltered,
+                     (long)autoBrightnessDark * 16,
+                     (long)autoBrightnessBright * 16,
+                     autoBrightnessMin, autoBrightnessMax);
+  }
+  brightness = constrain(brightness,
+                         min(autoBrightnessMin, autoBrightnessMax),
+                         max(autoBrightnessMin, autoBrightnessMax));
+  byte output = readTable(lightCorrectionTable, brightness);
+
+  // Only write to the displays when the output changed by enough, but always
+  // let it reach the ends of the range
+  int change = abs((int)output - (int)autoBrightnessOutput);
+  bool atEnd = (brightness == autoBrightnessMin ||
+                brightness == autoBrightnessMax);
+  if (firstReading == false)
+  {
+    if (change == 0) return;
+    if (change < autoBrightnessThreshold && atEnd == false) return;
+  }
+
+  autoBrightnessOutput = output;
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    displayPWM[i] = output;
+  }
+
+  // The PWM registers are only written for displays whose value changed.
+  // Displays that went idle get the new brightness when they wake up.
+  beginCurrentChange();
+  endCurrentChange();
+}
+#endif
+
+/*
+ * Returns the milliseconds until tick() has something to do next, or
+ * REBOOT_NO_DEADLINE if nothing is scheduled
+ */
+unsigned long GhostLab42Reboot::nextDeadline()
+{
+  unsigned long wait = REBOOT_NO_DEADLINE;
+  unsigned long now = clockMillis();
+
+  // Nothing reads the time when all of the effects are left out
+  (void)now;
+
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+  if (autoBrightnessPin >= 0)
+  {
+    wait = earlierWait(wait, autoBrightnessLastSample + autoBrightnessInterval,
+                       now);
+  }
+#endif
+
+#if REBOOT_ENABLE_GROUPS
+  // A fade only needs a step when its level changes, which happens every
+  // duration / levels milliseconds
+  for (int groupID = 0; groupID < REBOOT_GROUP_COUNT; groupID++)
+  {
+    if (groupFadeDuration[groupID] == 0) continue;
+
+    unsigned long duration = groupFadeDuration[groupID];
+    unsigned long levels = abs((int)groupFadeTo[groupID] -
+                               (int)groupFadeFrom[groupID]);
+    unsigned long elapsed = now - groupFadeStart[groupID];
+    unsigned long next = duration;
+
+    if (levels > 0 && elapsed < duration)
+    {
+      unsigned long level = levels * elapsed / duration;
+      next = ((level + 1) * duration + levels - 1) / levels;
+    }
+
+    wait = earlierWait(wait, groupFadeStart[groupID] + next, now);
+  }
+#endif
+
+#if REBOOT_ENABLE_SCROLL
+  if (scrolling)
+  {
+    wait = earlierWait(wait, scrollLastStep + scrollInterval, now);
+  }
+#endif
+
+  for (int displayID = 0; displayID < REBOOT_DISPLAY_COUNT; displayID++)
+  {
+#if REBOOT_ENABLE_TRANSITIONS
+    if (transitionMode[displayID] != Transition_None)
+    {
+      wait = earlierWait(wait, transitionLastStep[displayID] +
+                         transitionInterval[displayID], now);
+    }
+#endif
+
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+    // Same conditions as the idle timeout in tick()
+    if (idleTimeout != 0 && displayBlinking(displayID) == false &&
+        transitionRunning(displayID) == false &&
+        displayAsleep[displayID] == false &&
+        displayBlanked[displayID] == false)
+    {
+      wait = earlierWait(wait, lastActivity[displayID] + idleTimeout, now);
+    }
+#endif
+
+#if REBOOT_ENABLE_BLINK
+    // Blinking displays change at the end of the on and the off part of the
+    // cycle, unless they are always on or always off
+    unsigned long period = blinkPeriod[displayID];
+    unsigned long onTime = blinkOnTime[displayID];
+    if (period != 0 && onTime != 0 && onTime != period)
+    {
+      unsigned long phase = (now - blinkStart[displayID]) % period;
+      unsigned long left = (phase < onTime) ? onTime - phase : period - phase;
+      wait = earlierWait(wait, now + left, now);
+    }
+#endif
+  }
+
+#if REBOOT_FRAME_CLOCK > 0
+  // The frame clock counts in microseconds, so round up to the millisecond
+  // the next frame is due in
+  if (frameClockPeriod != 0)
+  {
+#if REBOOT_FRAME_CLOCK_TIMER > 0
+    noInterrupts();
+    bool due = (frameClockTicks != 0);
+    unsigned long next = frameClockTime + frameClockPeriod;
+    interrupts();
+    if (due) return 0;
+
+    // The timer runs on real time, whatever clock is set
+    unsigned long micro = micros();
+#else
+    unsigned long next = frameClockNext;
+    unsigned long micro = clockMicros();
+#endif
+    if ((long)(next - micro) <= 0) return 0;
+    wait = earlierWait(wait, now + (next - micro + 999) / 1000, now);
+  }
+#endif
+
+  return wait;
+}
+
+/*
+ * Returns the font the display converts characters with, which is always the
+ * default font when fonts are left out of the library
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+const RebootFont *GhostLab42Reboot::currentFont(int displayID)
+{
+#if REBOOT_ENABLE_FONTS
+  return displayFont[displayID];
+#else
+  return &rebootDefaultFont;
+#endif
+}
+
+/*
+ * Converts the characters into segment data in the frame buffer of the
+ * display. Only the digits that change are marked as dirty.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * value     Characters to convert
+ */
+void GhostLab42Reboot::encodeFrame(int displayID, String value)
+{
+  byte cells[REBOOT_MAX_DIGITS];
+  int cellCount = cacheEncodeCells(currentFont(displayID), value.c_str(),
+                                   cells, digitCount(displayID));
+
+  // The cells are mapped to the wiring of the display in setCell()
+  for (int i = 0; i < cellCount; i++)
+  {
+    setCell(displayID, i, cells[i]);
+  }
+}
+
+/*
+ * Converts the characters into segment data (one byte per digit) and returns
+ * the number of digits all of the characters take up, including the ones that
+ * did not fit in cells. The characters are read in a single pass, looking at
+ * most one character ahead for a decimal.
+ *
+ * Parameters:
+ * font     Font to convert the characters with
+ * text     Characters to convert
+ * cells    Receives the segment data
+ * maxCells Number of digits that fit in cells, 0 to only count the digits
+ * skip     Number of digits to leave out at the start
+ */
+int GhostLab42Reboot::encodeCells(const RebootFont *font, const char *text,
+                                  byte cells[], int maxCells, int skip)
+{
+  // Segment data for a character, some characters need more than one digit
+  byte characterCells[REBOOT_GLYPH_CELLS];
+
+  // Number of digits so far, and the next digit of cells that will be filled
+  int width = 0;
+  int column = 0;
+
+  while (*text != 0)
+  {
+    char character = *text;
+    bool decimal = false;
+
+    if (character == '.')
+    {
+      // A decimal that does not follow a regular character (at the start or
+      // after another decimal) gets a blank digit of its own
+      character = ' ';
+      decimal = true;
+      text++;
+    }
+    else if (text[1] == '.')
+    {
+      // A decimal after a regular character is written as part of the
+      // character. At the end of the text text[1] is the terminating 0.
+      decimal = true;
+      text += 2;
+    }
+    else
+    {
+      text++;
+    }
+
+    byte cellCount = writeCharacter(font, character, decimal, characterCells);
+    width += cellCount;
+
+    // Store the digits that are not skipped and still fit, anything else is
+    // cut off
+    for (byte j = 0; j < cellCount; j++)
+    {
+      if (skip > 0)
+      {
+        skip--;
+      }
+      else if (column < maxCells)
+      {
+        cells[column] = characterCells[j];
+        column++;
+      }
+    }
+  }
+
+  return width;
+}
+
+/*
+ * Converts the characters into segment data like encodeCells(), but looks in
+ * the frame cache first. Characters that are not in the cache are converted
+ * and replace the frame that was used the longest time ago.
+ *
+ * Parameters:
+ * font     Font to convert the characters with
+ * text     Characters to convert
+ * cells    Receives the segment data
+ * maxCells Number of digits that fit in cells
+ */
+int GhostLab42Reboot::cacheEncodeCells(const RebootFont *font,
+                                       const char *text, byte cells[],
+                                       int maxCells)
+{
+#if REBOOT_FRAME_CACHE > 0
+  // FNV-1a hash of the characters
+  unsigned long hash = 2166136261UL;
+  unsigned int length = 0;
+  for (const char *c = text; *c != 0; c++)
+  {
+    hash ^= (byte)*c;
+    hash *= 16777619UL;
+    length++;
+  }
+
+  byte oldest = 0;
+  cacheUses++;
+
+  for (byte i = 0; i < REBOOT_FRAME_CACHE; i++)
+  {
+    if (cacheLastUse[i] != 0 && cacheHash[i] == hash &&
+        cacheLength[i] == length && cacheFont[i] == font &&
+        cacheDigits[i] == maxCells)
+    {
+#if REBOOT_ENABLE_STATISTICS
+      cacheHits++;
+#endif
+      cacheLastUse[i] = cacheUses;
+      memcpy(cells, cacheCells[i], cacheCellCount[i]);
+      return cacheCellCount[i];
+    }
+
+    if (cacheLastUse[i] < cacheLastUse[oldest]) oldest = i;
+  }
+
+#if REBOOT_ENABLE_STATISTICS
+  cacheMisses++;
+#endif
+
+  // min() is a macro that would convert the characters twice
+  int cellCount = encodeCells(font, text, cells, maxCells, 0);
+  if (cellCount > maxCells) cellCount = maxCells;
+
+  cacheHash[oldest] = hash;
+  cacheLength[oldest] = length;
+  cacheFont[oldest] = font;
+  cacheDigits[oldest] = maxCells;
+  cacheCellCount[oldest] = cellCount;
+  memcpy(cacheCells[oldest], cells, cellCount);
+  cacheLastUse[oldest] = cacheUses;
+
+  return cellCount;
+#else
+  // min() is a macro that would convert the characters twice
+  int cellCount = encodeCells(font, text, cells, maxCells, 0);
+  return (cellCount > maxCells) ? maxCells : cellCount;
+#endif
+}
+
+/*
+ * Converts the characters into segment data that fills all of the digits,
+ * lined up and cut off as asked. The characters only have to be converted a
+ * second time when they are cut off at the start.
+ *
+ * Parameters:
+ * font      Font to convert the characters with
+ * text      Characters to convert
+ * cells     Receives the segment data
+ * cellCount Number of digits to fill
+ * alignment REBOOT_ALIGN_LEFT, REBOOT_ALIGN_RIGHT or REBOOT_ALIGN_CENTER
+ * overflow  REBOOT_OVERFLOW_TRUNCATE or REBOOT_OVERFLOW_ELLIPSIS
+ */
+void GhostLab42Reboot::layoutCells(const RebootFont *font, const char *text,
+                                   byte cells[], int cellCount, int alignment,
+                                   int overflow)
+{
+  // An empty canvas has no digits to lay out
+  if (cellCount <= 0) return;
+
+  memset(cells, 0x00, cellCount);
+  int width = encodeCells(font, text, cells, cellCount, 0);
+  int space = cellCount - width;
+
+  if (alignment != REBOOT_ALIGN_LEFT && space > 0)
+  {
+    // Move the characters over, and blank the digits in front of them
+    int lead = (alignment == REBOOT_ALIGN_RIGHT) ? space : space / 2;
+    memmove(cells + lead, cells, width);
+    memset(cells, 0x00, lead);
+  }
+  else if (alignment != REBOOT_ALIGN_LEFT && space < 0)
+  {
+    // Leave out the digits that are cut off at the start
+    int skip = (alignment == REBOOT_ALIGN_RIGHT) ? -space : -space / 2;
+    encodeCells(font, text, cells, cellCount, skip);
+  }
+
+  // Mark the ends that were cut off
+  if (space < 0 && overflow == REBOOT_OVERFLOW_ELLIPSIS)
+  {
+    if (alignment != REBOOT_ALIGN_RIGHT) cells[cellCount - 1] = 0x80;
+    if (alignment != REBOOT_ALIGN_LEFT) cells[0] = 0x80;
+  }
+}
+
+#if REBOOT_ENABLE_PRINT
+/*
+ * Shows segment data on the display, lined up to the left, right or center.
+ * Digits that are not filled are blanked.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * cells     Segment data (gfedcba format)
+ * cellCount Number of digits in cells, no more than the display has
+ * alignment REBOOT_ALIGN_LEFT, REBOOT_ALIGN_RIGHT or REBOOT_ALIGN_CENTER
+ */
+void GhostLab42Reboot::showCells(int displayID, const byte cells[],
+                                 int cellCount, int alignment)
+{
+  int lead = 0;
+  if (alignment == REBOOT_ALIGN_RIGHT)
+  {
+    lead = digitCount(displayID) - cellCount;
+  }
+  else if (alignment == REBOOT_ALIGN_CENTER)
+  {
+    lead = (digitCount(displayID) - cellCount) / 2;
+  }
+
+  for (int i = 0; i < digitCount(displayID); i++)
+  {
+    byte segments = 0x00;
+    if (i >= lead && i < lead + cellCount) segments = cells[i - lead];
+
+    setCell(displayID, i, segments);
+  }
+
+  commitFrame(displayID);
+}
+
+/*
+ * Formats characters for printf() and prints them, and returns the number of
+ * characters that were printed
+ *
+ * Parameters:
+ * out           Where to print the characters
+ * format        Format of the characters
+ * formatInFlash Whether the format is stored in flash
+ * args          Values for the conversions in the format
+ */
+int GhostLab42Reboot::formatText(Print &out, const char *format,
+                                 bool formatInFlash, va_list args)
+{
+  int count = 0;
+
+  // Digits of a number, enough for an unsigned long
+  char digits[11];
+
+  while (true)
+  {
+    char c = formatInFlash ? pgm_read_byte(format) : *format;
+    format++;
+
+    if (c == 0) break;
+
+    if (c != '%')
+    {
+      out.write(c);
+      count++;
+      continue;
+    }
+
+    // Flags, width and length of the conversion
+    bool leftJustify = false;
+    bool zeroPad = false;
+    bool isLong = false;
+    unsigned int width = 0;
+
+    c = formatInFlash ? pgm_read_byte(format) : *format;
+    format++;
+
+    while (c == '-' || c == '0')
+    {
+      if (c == '-') leftJustify = true;
+      else zeroPad = true;
+
+      c = formatInFlash ? pgm_read_byte(format) : *format;
+      format++;
+    }
+
+    while (c >= '0' && c <= '9')
+    {
+      width = width * 10 + (c - '0');
+      c = formatInFlash ? pgm_read_byte(format) : *format;
+      format++;
+    }
+
+    if (c == 'l')
+    {
+      isLong = true;
+      c = formatInFlash ? pgm_read_byte(format) : *format;
+      format++;
+    }
+
+    // The format ended in the middle of a conversion
+    if (c == 0) break;
+
+    const char *text = digits;
+    unsigned int length = 0;
+    bool negative = false;
+
+    if (c == 'd' || c == 'i')
+    {
+      long value = isLong ? va_arg(args, long) : va_arg(args, int);
+      negative = (value < 0);
+      unsigned long magnitude = negative ? 0UL - (unsigned long)value : value;
+      length = formatNumber(digits, magnitude, 10, false);
+    }
+    else if (c == 'u' || c == 'x' || c == 'X')
+    {
+      unsigned long value = isLong ? va_arg(args, unsigned long)
+                                   : va_arg(args, unsigned int);
+      length = formatNumber(digits, value, (c == 'u') ? 10 : 16, (c == 'X'));
+    }
+    else if (c == 'c')
+    {
+      digits[0] = (char)va_arg(args, int);
+      length = 1;
+    }
+    else if (c == 's')
+    {
+      text = va_arg(args, const char *);
+      if (text == NULL) text = "";
+      length = strlen(text);
+    }
+    else
+    {
+      // %% and anything that is not supported is printed as it is
+      digits[0] = c;
+      length = 1;
+    }
+
+    // Line up the conversion in its width
+    unsigned int padding = 0;
+    if (width > length + negative) padding = width - length - negative;
+
+    if (leftJustify == false && zeroPad == false)
+    {
+      for (unsigned int i = 0; i < padding; i++) out.write(' ');
+    }
+
+    if (negative) out.write('-');
+
+    if (leftJustify == false && zeroPad)
+    {
+      for (unsigned int i = 0; i < padding; i++) out.write('0');
+    }
+
+    for (unsigned int i = 0; i < length; i++) out.write(text[i]);
+
+    if (leftJustify)
+    {
+      for (unsigned int i = 0; i < padding; i++) out.write(' ');
+    }
+
+    count += padding + negative + length;
+  }
+
+  return count;
+}
+#endif
+
+#if REBOOT_ENABLE_CANVAS
+/*
+ * Puts a window of the segment data onto the canvas. Digits of the canvas that
+ * fall outside of the segment data are blanked.
+ *
+ * Parameters:
+ * cells     Segment data, one byte per digit
+ * cellCount Number of digits in cells
+ * offset    Digit of cells that goes on the leftmost digit of the canvas, can
+ *           be negative
+ */
+void GhostLab42Reboot::drawCanvas(const byte cells[], int cellCount,
+                                  int offset)
+{
+  int cell = offset;
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    int displayID = canvasOrder[i];
+    if (displayID == -1) continue;
+
+    for (byte column = 0; column < digitCount(displayID); column++)
+    {
+      byte segments = 0x00;
+      if (cell >= 0 && cell < cellCount) segments = cells[cell];
+
+      setCell(displayID, column, segments);
+      cell++;
+    }
+  }
+}
+
+/*
+ * Shows the changes to the canvas on the displays that changed
+ */
+void GhostLab42Reboot::commitCanvas()
+{
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    int displayID = canvasOrder[i];
+    if (displayID == -1) continue;
+
+    if (dirtyFirst[displayID] <= dirtyLast[displayID] ||
+        transitionRunning(displayID))
+    {
+      commitFrame(displayID);
+    }
+  }
+}
+
+/*
+ * Returns the font the canvas converts characters with, which is always the
+ * default font when fonts are left out of the library
+ */
+const RebootFont *GhostLab42Reboot::currentCanvasFont()
+{
+#if REBOOT_ENABLE_FONTS
+  return canvasFont;
+#else
+  return &rebootDefaultFont;
+#endif
+}
+#endif
+
+/*
+ * Changes one digit of the frame buffer, and marks it as dirty if it changed
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * column    Digit of the display, counting from the left as it is mounted
+ * segments  Segment data for the digit (gfedcba format)
+ */
+void GhostLab42Reboot::setCell(int displayID, byte column, byte segments)
+{
+  segments = mapSegments(displayID, segments);
+
+  if (frameBuffer[displayID][column] == segments) return;
+
+  frameBuffer[displayID][column] = segments;
+  if (column < dirtyFirst[displayID]) dirtyFirst[displayID] = column;
+  if (column > dirtyLast[displayID]) dirtyLast[displayID] = column;
+}
+
+/*
+ * Converts segment data from the gfedcba format to the wiring of the display
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * segments  Segment data (gfedcba format)
+ */
+byte GhostLab42Reboot::mapSegments(int displayID, byte segments)
+{
+#if REBOOT_ENABLE_ORIENTATION
+  if (segmentMap[displayID] == NULL) return segments;
+
+  return readTable(segmentMap[displayID], segments);
+#else
+  return segments;
+#endif
+}
+
+#if REBOOT_ENABLE_ORIENTATION
+/*
+ * Blanks the frame buffer and every digit of the display. Used when the
+ * orientation or segment map changes, so every digit is sent: the digits
+ * that were lit may be in other registers than the frame buffer maps to now.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::clearFrame(int displayID)
+{
+#if REBOOT_ENABLE_TRANSITIONS
+  finishTransition(displayID);
+#endif
+
+  for (byte i = 0; i < digitCount(displayID); i++)
+  {
+    frameBuffer[displayID][i] = mapSegments(displayID, 0x00);
+  }
+  dirtyFirst[displayID] = 0;
+  dirtyLast[displayID] = digitCount(displayID) - 1;
+
+  commitFrame(displayID);
+}
+#endif
+
+/*
+ * Marks the frame buffer of the display as shown
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::clearDirty(int displayID)
+{
+  dirtyFirst[displayID] = 0xFF;
+  dirtyLast[displayID] = 0;
+}
+
+/*
+ * Shows the frame buffer after it was changed. Only the span of digits that
+ * changed since the frame buffer was last shown is sent.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::commitFrame(int displayID)
+{
+  unsigned long commitStart = traceStart();
+  markActivity(displayID);
+
+#if REBOOT_ENABLE_TRANSITIONS
+  // A new write replaces the transition, which may have left the display
+  // showing parts of the old frame, or dimmed partway through a dip
+  if (transitionMode[displayID] != Transition_None)
+  {
+    if (transitionMode[displayID] == Transition_Dip)
+    {
+      writeRegister(displayID, IS31FL3730_PWM_Register, outputPWM[displayID]);
+    }
+
+    transitionMode[displayID] = Transition_None;
+    dirtyFirst[displayID] = 0;
+    dirtyLast[displayID] = digitCount(displayID) - 1;
+  }
+#endif
+
+  // Waking up sends the whole frame buffer, so there is nothing left to do
+  if (displayIdle(displayID))
+  {
+    wakeDisplay(displayID);
+    traceSpan(REBOOT_TRACE_COMMIT, displayID, commitStart);
+    return;
+  }
+
+  // Make room in the current budget before more segments light up
+  beginCurrentChange();
+
+  // Make sure the maximum current for the display is not exceeded
+  refreshDisplayCurrent(displayID);
+
+  if (dirtyFirst[displayID] <= dirtyLast[displayID])
+  {
+    sendFrame(displayID, dirtyFirst[displayID],
+              dirtyLast[displayID] - dirtyFirst[displayID] + 1);
+    clearDirty(displayID);
+  }
+
+  endCurrentChange();
+  traceSpan(REBOOT_TRACE_COMMIT, displayID, commitStart);
+}
+
+/*
+ * Checks if the display is lit. Blinking displays count as lit, so the
+ * current budget does not have to change every time they blink.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::drawsCurrent(int displayID)
+{
+  if (displayIdle(displayID)) return false;
+  if (displayBlanked[displayID] && displayBlinking(displayID) == false)
+  {
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Estimates the average current (in uA) the display draws with the frame
+ * buffer it is showing. During a transition the segments of the old frame are
+ * counted as well, since any of them can be lit.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * pwm       PWM register value (0 - 128)
+ * current   Lighting Effect Register current setting
+ */
+unsigned long GhostLab42Reboot::estimateCurrent(int displayID, byte pwm,
+                                                byte current)
+{
+  // Count the lit segments
+  unsigned long segments = 0;
+  for (int i = 0; i < digitCount(displayID); i++)
+  {
+    byte lit = frameBuffer[displayID][i];
+#if REBOOT_ENABLE_TRANSITIONS
+    // A transition can show any of the segments of the old and new frames
+    if (transitionMode[displayID] != Transition_None)
+    {
+      lit |= transitionFrom[displayID][i];
+    }
+#endif
+    segments += __builtin_popcount(lit);
+  }
+
+  unsigned long milliamps = currentMilliamps(current);
+
+  return segments * milliamps * 1000 * pwm /
+         (IS31FL3730_PWM_Default * IS31FL3730_Scan_Columns);
+}
+
+#if REBOOT_ENABLE_CURRENT_BUDGET
+/*
+ * Works out the PWM value and current setting each display should use to stay
+ * within the current budget
+ */
+void GhostLab42Reboot::updateCurrentBudget()
+{
+  // Estimated current at the brightness the user asked for, in uA
+  unsigned long total = 0;
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    targetPWM[i] = displayPWM[i];
+    targetCurrent[i] = displayMaxCurrent[i];
+
+    if (drawsCurrent(i))
+    {
+      total += estimateCurrent(i, displayPWM[i], displayMaxCurrent[i]);
+    }
+  }
+
+  unsigned long budget = (unsigned long)currentBudget * 1000;
+  if (currentBudget == 0 || total <= budget) return;
+
+  // Fraction of the requested light output that fits in the budget (x/256)
+  unsigned long scale = budget / ((total + 255) / 256);
+
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    // Light output the display is allowed to have, as PWM value times mA
+    unsigned long drive = (unsigned long)displayPWM[i] *
+      currentMilliamps(displayMaxCurrent[i]) * scale / 256;
+
+    // Lower current settings are more efficient than dimming with PWM, so use
+    // the lowest setting that can still give the light output (never going
+    // over the setting picked for the display)
+    for (byte j = 0; j < IS31FL3730_Current_Setting_Count &&
+         readTable(IS31FL3730_Current_Settings, j) <= displayMaxCurrent[i]; j++)
+    {
+      unsigned long pwm = drive / readTable(IS31FL3730_Current_Milliamps, j);
+      if (pwm <= IS31FL3730_PWM_Default)
+      {
+        targetPWM[i] = pwm;
+        targetCurrent[i] = readTable(IS31FL3730_Current_Settings, j);
+        break;
+      }
+    }
+  }
+}
+#endif
+
+/*
+ * Sends the PWM values and current settings worked out by
+ * updateCurrentBudget() to the displays that need them. Displays that get
+ * dimmer are handled separately from the ones that get brighter, so the
+ * displays can be dimmed before anything else draws more current.
+ *
+ * Parameters:
+ * increases True to update the displays that get brighter, false to update
+ *           the ones that get dimmer
+ */
+void GhostLab42Reboot::applyCurrentBudget(bool increases)
+{
+  for (int i = 0; i < REBOOT_DISPLAY_COUNT; i++)
+  {
+    // Displays that went idle get their settings when they wake up
+    if (displayIdle(i)) continue;
+
+#if REBOOT_ENABLE_CURRENT_BUDGET
+    byte pwm = targetPWM[i];
+    byte current = targetCurrent[i];
+#else
+    // Without a budget the displays use the settings they were given
+    byte pwm = displayPWM[i];
+    byte current = displayMaxCurrent[i];
+#endif
+
+    unsigned int before = outputPWM[i] * currentMilliamps(displayCurrent[i]);
+    unsigned int after = pwm * currentMilliamps(current);
+
+    if ((after > before) == increases) writeDisplayOutput(i, false);
+  }
+}
+
+/*
+ * Writes the PWM value and current setting from the current budget to the
+ * display if they changed
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * force     True to write both registers even if they did not change
+ */
+void GhostLab42Reboot::writeDisplayOutput(int displayID, bool force)
+{
+#if REBOOT_ENABLE_CURRENT_BUDGET
+  byte pwm = targetPWM[displayID];
+  byte current = targetCurrent[displayID];
+#else
+  // Without a budget the display uses the settings it was given
+  byte pwm = displayPWM[displayID];
+  byte current = displayMaxCurrent[displayID];
+#endif
+
+  bool pwmChanged = force || (pwm != outputPWM[displayID]);
+  bool currentChanged = force || (current != displayCurrent[displayID]);
+
+  outputPWM[displayID] = pwm;
+
+  // When the current goes up the PWM value goes down, so change the PWM value
+  // first to never be brighter than the old or new setting
+  if (pwmChanged && current > displayCurrent[displayID])
+  {
+    writeRegister(displayID, IS31FL3730_PWM_Register, outputPWM[displayID]);
+    pwmChanged = false;
+  }
+
+  if (currentChanged)
+  {
+    displayCurrent[displayID] = current;
+    refreshDisplayCurrent(displayID);
+  }
+
+  if (pwmChanged)
+  {
+    writeRegister(displayID, IS31FL3730_PWM_Register, outputPWM[displayID]);
+  }
+}
+
+/*
+ * Updates the current budget before a change that can make the displays draw
+ * more current, and dims any display that has to get dimmer
+ */
+void GhostLab42Reboot::beginCurrentChange()
+{
+#if REBOOT_ENABLE_CURRENT_BUDGET
+  updateCurrentBudget();
+#endif
+  applyCurrentBudget(false);
+}
+
+/*
+ * Brightens any display that can get brighter after a change
+ */
+void GhostLab42Reboot::endCurrentChange()
+{
+  applyCurrentBudget(true);
+}
+
+/*
+ * Sends part of the frame buffer to the display's data registers and shows it
+ *
+ * Parameters:
+ * displayID   Unique identifier for the display
+ * firstColumn First digit to send
+ * columnCount Number of digits to send
+ */
+void GhostLab42Reboot::sendFrame(int displayID, int firstColumn,
+                                 int columnCount)
+{
+  writeColumns(displayID, frameBuffer[displayID], firstColumn, columnCount);
+
+  // Set the current again, in case a wire was unplugged sometime between
+  // the last current reset and now
+  refreshDisplayCurrent(displayID);
+
+  updateColumns(displayID);
+}
+
+/*
+ * Writes segment data to the display's temporary data registers
+ *
+ * Parameters:
+ * displayID   Unique identifier for the display
+ * frame       Segment data for every digit of the display
+ * firstColumn First digit to send
+ * columnCount Number of digits to send
+ */
+void GhostLab42Reboot::writeColumns(int displayID, const byte frame[],
+                                    int firstColumn, int columnCount)
+{
+  // Write the display data in the temporary registers
+  setupWireTransmission(displayID);
+
+#if REBOOT_ENABLE_ORIENTATION
+  if (reverseColumns[displayID])
+  {
+    // The display is mounted the other way around, so the last digit of the
+    // frame goes to the first data register
+    int lastColumn = digitCount(displayID) - 1;
+    int firstRegister = lastColumn - (firstColumn + columnCount - 1);
+    Wire.write(IS31FL3730_Data_Registers + firstRegister);
+
+    for (int i = firstColumn + columnCount - 1; i >= firstColumn; i--)
+    {
+      Wire.write(frame[i]);
+#if REBOOT_MIRROR_COUNT > 0
+      registerData[displayID][lastColumn - i] = frame[i];
+#endif
+    }
+  }
+  else
+#endif
+  {
+    Wire.write(IS31FL3730_Data_Registers + firstColumn);
+
+    for (int i = firstColumn; i < firstColumn + columnCount; i++)
+    {
+      Wire.write(frame[i]);
+#if REBOOT_MIRROR_COUNT > 0
+      registerData[displayID][i] = frame[i];
+#endif
+    }
+  }
+
+  // End the temporary register transmission
+  endAddressTransmission();
+#if REBOOT_ENABLE_STATISTICS
+  busBytes += 1 + columnCount;
+#endif
+}
+
+/*
+ * Shows what was written to the temporary data registers
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::updateColumns(int displayID)
+{
+  // Write to the Update Column Register to let the board know we want to
+  // update the display
+  // Send any value to initate the display (value ignored)
+  writeRegister(displayID, IS31FL3730_Update_Column_Register, 0x00);
+}
+
+/*
+ * Returns true if the display is in the middle of a transition, which is
+ * never the case when transitions are left out of the library
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+bool GhostLab42Reboot::transitionRunning(int displayID)
+{
+#if REBOOT_ENABLE_TRANSITIONS
+  return transitionMode[displayID] != Transition_None;
+#else
+  return false;
+#endif
+}
+
+#if REBOOT_ENABLE_TRANSITIONS
+/*
+ * Starts a transition to new characters. The frame the display is showing is
+ * kept and the characters are converted into the frame buffer. Returns false
+ * if there is nothing to transition, in which case the new frame was shown
+ * straight away. The current budget is made to cover both frames before any
+ * of the new segments are shown.
+ *
+ * Parameters:
+ * displayID  Unique identifier for the display
+ * value      Characters to transition to
+ * durationMs Length of the transition in milliseconds
+ * mode       Transition_Crossfade or Transition_Segments
+ */
+bool GhostLab42Reboot::beginTransition(int displayID, String value,
+                                       unsigned long durationMs, byte mode)
+{
+  // Finish any transition that is still running, then remember the frame the
+  // display is showing
+  finishTransition(displayID);
+  memcpy(transitionFrom[displayID], frameBuffer[displayID],
+         sizeof(transitionFrom[displayID]));
+
+  encodeFrame(displayID, value);
+  markActivity(displayID);
+
+  // Only the digits that differ have to be switched
+  int first = 0;
+  int last = digitCount(displayID) - 1;
+  while (first <= last &&
+         transitionFrom[displayID][first] == frameBuffer[displayID][first])
+  {
+    first++;
+  }
+  while (last >= first &&
+         transitionFrom[displayID][last] == frameBuffer[displayID][last])
+  {
+    last--;
+  }
+
+  // Nothing to transition, or no time to do it in
+  if (first > last || durationMs == 0 || displayIdle(displayID))
+  {
+    commitFrame(displayID);
+    return false;
+  }
+
+  transitionMode[displayID] = mode;
+  transitionFirstColumn[displayID] = first;
+  transitionColumnCount[displayID] = last - first + 1;
+  transitionShowingNew[displayID] = false;
+  transitionAccumulator[displayID] = 0;
+  transitionStart[displayID] = clockMillis();
+  transitionLastStep[displayID] = transitionStart[displayID];
+  transitionDuration[displayID] = durationMs;
+#if REBOOT_ENABLE_STATISTICS
+  transitionBytes[displayID] = 0;
+  transitionTransactions[displayID] = 0;
+#endif
+
+  // The steps show a mix of the old and new frames, so the budget has to
+  // cover the segments of both until the transition is finished
+  beginCurrentChange();
+  endCurrentChange();
+
+  return true;
+}
+
+/*
+ * Returns the number of steps a segment transition effect takes
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * effect    Segment transition effect
+ */
+byte GhostLab42Reboot::segmentTransitionSteps(int displayID, int effect)
+{
+  if (effect == REBOOT_WIPE_LEFT_TO_RIGHT) return digitCount(displayID);
+  if (effect == REBOOT_WIPE_TOP_DOWN) return sizeof(Wipe_Top_Down_Bands);
+  if (effect == REBOOT_DISSOLVE) return 8;
+
+  // Morphing changes one segment of each digit per step, so it takes as many
+  // steps as the digit with the most segments to change
+  byte steps = 1;
+  for (byte i = 0; i < digitCount(displayID); i++)
+  {
+    byte changes = __builtin_popcount(transitionFrom[displayID][i] ^
+                                      frameBuffer[displayID][i]);
+    if (changes > steps) steps = changes;
+  }
+  return steps;
+}
+
+/*
+ * Returns the segments of one digit at a step of a segment transition, made
+ * from the old frame and the new frame buffer
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * effect    Segment transition effect
+ * column    Digit of the display
+ * step      Step of the transition, from 1 to steps
+ * steps     Number of steps in the transition
+ */
+byte GhostLab42Reboot::segmentTransitionFrame(int displayID, int effect,
+                                              byte column, byte step,
+                                              byte steps)
+{
+  byte from = transitionFrom[displayID][column];
+  byte to = frameBuffer[displayID][column];
+
+  // The last step is always the new frame
+  if (step >= steps) return to;
+
+  // Segments that already show the new frame
+  byte mask = 0x00;
+
+  if (effect == REBOOT_WIPE_LEFT_TO_RIGHT)
+  {
+    if (column < step) mask = 0xFF;
+  }
+  else if (effect == REBOOT_WIPE_TOP_DOWN)
+  {
+    for (byte i = 0; i < step; i++)
+    {
+      mask |= mapSegments(displayID, readTable(Wipe_Top_Down_Bands, i));
+    }
+  }
+  else if (effect == REBOOT_DISSOLVE)
+  {
+    // Each digit switches its segments in a different order, one per step
+    for (byte segment = 0; segment < 8; segment++)
+    {
+      if (((segment * 3 + column * 5) & 0x07) < step) mask |= (1 << segment);
+    }
+  }
+  else
+  {
+    // Morph: turn off the old segments one at a time, then turn on the new
+    // ones one at a time
+    byte changes = step;
+    byte off = from & ~to;
+    byte on = to & ~from;
+
+    for (byte segment = 0; segment < 8 && changes > 0; segment++)
+    {
+      if (off & (1 << segment)) { mask |= (1 << segment); changes--; }
+    }
+    for (byte segment = 0; segment < 8 && changes > 0; segment++)
+    {
+      if (on & (1 << segment)) { mask |= (1 << segment); changes--; }
+    }
+  }
+
+  return (to & mask) | (from & ~mask);
+}
+
+/*
+ * Moves the transition of the display one step along. Steps that change the
+ * digits set the current again first, like every other write to the display.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * now       Time of the step, from millis()
+ */
+void GhostLab42Reboot::stepTransition(int displayID, unsigned long now)
+{
+  transitionLastStep[displayID] = now;
+
+  unsigned long elapsed = now - transitionStart[displayID];
+  if (elapsed >= transitionDuration[displayID])
+  {
+    finishTransition(displayID);
+    return;
+  }
+
+#if REBOOT_ENABLE_STATISTICS
+  unsigned long startBytes = busBytes;
+  unsigned long startTransactions = busTransactions;
+#endif
+
+  // How far along the transition is (0 - 255)
+  unsigned int progress = elapsed * 256 / transitionDuration[displayID];
+
+  if (transitionMode[displayID] == Transition_Segments)
+  {
+    // The old frame is updated with the digits that change in this step, and
+    // only the span of digits that changed is sent
+    byte first = REBOOT_MAX_DIGITS;
+    byte last = 0;
+    byte index = transitionDeltaIndex[displayID];
+
+    while (index < transitionDeltaCount[displayID])
+    {
+      byte column = transitionDeltas[displayID][index][0] & 0x7F;
+      bool endOfStep = transitionDeltas[displayID][index][0] & 0x80;
+
+      transitionFrom[displayID][column] = transitionDeltas[displayID][index][1];
+      if (column < first) first = column;
+      if (column > last) last = column;
+      index++;
+
+      if (endOfStep) break;
+    }
+
+    transitionDeltaIndex[displayID] = index;
+
+    if (first <= last)
+    {
+      refreshDisplayCurrent(displayID);
+      writeColumns(displayID, transitionFrom[displayID], first,
+                   last - first + 1);
+      updateColumns(displayID);
+    }
+
+    // The last step leaves the display showing the new frame
+    if (index >= transitionDeltaCount[displayID])
+    {
+      transitionShowingNew[displayID] = true;
+    }
+  }
+  else if (transitionMode[displayID] == Transition_Crossfade)
+  {
+    // Show the new frame in a growing share of the sub-frames. The error is
+    // carried over from one sub-frame to the next so the share is exact.
+    transitionAccumulator[displayID] += progress;
+    bool showNew = (transitionAccumulator[displayID] >= 256);
+    if (showNew) transitionAccumulator[displayID] -= 256;
+
+    // Only switch when the frame actually changes
+    if (showNew != transitionShowingNew[displayID])
+    {
+      refreshDisplayCurrent(displayID);
+      writeColumns(displayID,
+                   showNew ? frameBuffer[displayID] : transitionFrom[displayID],
+                   transitionFirstColumn[displayID],
+                   transitionColumnCount[displayID]);
+      updateColumns(displayID);
+      transitionShowingNew[displayID] = showNew;
+    }
+  }
+  else
+  {
+    // Fade the old frame out during the first half, then the new frame in
+    bool secondHalf = (progress >= 128);
+    unsigned int level = secondHalf ? (progress - 128) * 2 : 255 - progress * 2;
+
+    if (secondHalf && transitionShowingNew[displayID] == false)
+    {
+      refreshDisplayCurrent(displayID);
+      writeColumns(displayID, frameBuffer[displayID],
+                   transitionFirstColumn[displayID],
+                   transitionColumnCount[displayID]);
+      updateColumns(displayID);
+      transitionShowingNew[displayID] = true;
+    }
+
+    writeRegister(displayID, IS31FL3730_PWM_Register,
+                  (unsigned int)outputPWM[displayID] * level / 255);
+  }
+
+#if REBOOT_ENABLE_STATISTICS
+  transitionBytes[displayID] += busBytes - startBytes;
+  transitionTransactions[displayID] += busTransactions - startTransactions;
+#endif
+}
+
+/*
+ * Ends the transition of the display, leaving it showing the new frame at its
+ * normal brightness
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::finishTransition(int displayID)
+{
+  if (transitionMode[displayID] == Transition_None) return;
+
+#if REBOOT_ENABLE_STATISTICS
+  unsigned long startBytes = busBytes;
+  unsigned long startTransactions = busTransactions;
+#endif
+
+  if (transitionShowingNew[displayID] == false)
+  {
+    // Segment transitions can have changed any digit of the old frame
+    if (transitionMode[displayID] == Transition_Segments)
+    {
+      transitionFirstColumn[displayID] = 0;
+      transitionColumnCount[displayID] = digitCount(displayID);
+    }
+
+    writeColumns(displayID, frameBuffer[displayID],
+                 transitionFirstColumn[displayID],
+                 transitionColumnCount[displayID]);
+  }
+
+  // Make sure the maximum current for the display is not exceeded
+  refreshDisplayCurrent(displayID);
+
+  if (transitionShowingNew[displayID] == false) updateColumns(displayID);
+
+  if (transitionMode[displayID] == Transition_Dip)
+  {
+    writeRegister(displayID, IS31FL3730_PWM_Register, outputPWM[displayID]);
+  }
+
+  transitionMode[displayID] = Transition_None;
+  clearDirty(displayID);
+
+  // The current budget only has to cover the new frame now
+  beginCurrentChange();
+  endCurrentChange();
+#if REBOOT_ENABLE_STATISTICS
+  transitionBytes[displayID] += busBytes - startBytes;
+  transitionTransactions[displayID] += busTransactions - startTransactions;
+#endif
+
+  // The display counts as updated when the new frame is fully shown
+  markActivity(displayID);
+}
+#endif
+
+/*
+ * Writes the display's current setting (20mA per segment unless a lower one
+ * was picked with setDisplayCurrent() or by the current budget)
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::refreshDisplayCurrent(int displayID)
+{
+  // The display driver allows currents greater than the displays should
+  // take - do not allow anything over 20mA!
+  // The display driver resets to 40mA per segment which is too much. This
+  // should be called before every function that writes to the display to
+  // ensure that the current is not exceeded in the case that a wire is
+  // accidentally disconnected
+  // This write is never skipped, even if the setting has not changed, since
+  // there is no way to know if the display was reset
+  writeRegister(displayID, IS31FL3730_Lighting_Effect_Register,
+                displayCurrent[displayID]);
+}
+
+/*
+ * Set up the Wire transmission depending on the display being used
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ */
+void GhostLab42Reboot::setupWireTransmission(int displayID)
+{
+  byte address = IS31FL3730_DIGIT_6_I2C_ADDRESS;
+
+  if (displayID == 0)
+  {
+    // Use the six digit display
+    address = IS31FL3730_DIGIT_6_I2C_ADDRESS;
+  }
+  else if (displayID == 1)
+  {
+    // Use the smaller four digit display
+    address = IS31FL3730_DIGIT_4S_I2C_ADDRESS;
+  }
+  else if (displayID == 2)
+  {
+    // Use the four digit display
+    address = IS31FL3730_DIGIT_4_I2C_ADDRESS;
+  }
+
+#if REBOOT_MIRROR_COUNT > 0
+  // A mirror on the selected multiplexer channel with the same address would
+  // pick up the write as well
+  freeMainBusAddress(address);
+#endif
+  setupAddressTransmission(address);
+}
+
+/*
+ * Set up the Wire transmission to a board by its I2C address
+ *
+ * Parameters:
+ * address I2C address of the board
+ */
+void GhostLab42Reboot::setupAddressTransmission(byte address)
+{
+#if REBOOT_ENABLE_STATISTICS
+  // Count the transaction and its address byte
+  busTransactions++;
+  busBytes++;
+#endif
+
+#if REBOOT_TRACE_SPANS > 0
+  transactionStart = clockMicros();
+  transactionAddress = address;
+#endif
+
+  Wire.beginTransmission(address);
+}
+
+/*
+ * Ends the Wire transmission that was set up with setupAddressTransmission()
+ */
+void GhostLab42Reboot::endAddressTransmission()
+{
+  Wire.endTransmission();
+
+#if REBOOT_TRACE_SPANS > 0
+  traceSpan(REBOOT_TRACE_TRANSACTION, transactionAddress, transactionStart);
+#endif
+}
+
+/*
+ * Writes a single byte to one of the display's registers
+ *
+ * Parameters:
+ * displayID     Unique identifier for the display
+ * registerIndex Index of the IS31FL3730 register to write to
+ * value         8-bit value for the register
+ */
+void GhostLab42Reboot::writeRegister(int displayID, byte registerIndex,
+                                     byte value)
+{
+  setupWireTransmission(displayID);
+  Wire.write(registerIndex);
+  Wire.write(value);
+  endAddressTransmission();
+#if REBOOT_ENABLE_STATISTICS
+  busBytes += 2;
+#endif
+
+#if REBOOT_MIRROR_COUNT > 0
+  // Keep track of what the display shows, and copy it to the mirrors
+  // (the current is kept in displayCurrent already)
+  if (registerIndex == IS31FL3730_Configuration_Register)
+  {
+    registerConfig[displayID] = value;
+  }
+  else if (registerIndex == IS31FL3730_PWM_Register)
+  {
+    registerPWM[displayID] = value;
+  }
+  else if (registerIndex == IS31FL3730_Reset_Register)
+  {
+    memset(registerData[displayID], 0, sizeof(registerData[displayID]));
+    registerPWM[displayID] = IS31FL3730_PWM_Default;
+    registerConfig[displayID] = IS31FL3730_Configuration_Normal;
+  }
+
+  // The data registers only show up once the Update Column Register is
+  // written, so the mirrors only get the new segments then as well
+  if (mirrorCount != 0)
+  {
+    syncMirrors(displayID,
+                registerIndex == IS31FL3730_Update_Column_Register ||
+                registerIndex == IS31FL3730_Reset_Register);
+  }
+#endif
+}
+
+#if REBOOT_MIRROR_COUNT > 0
+/*
+ * Writes a single byte to one of the registers of a board by its I2C address
+ *
+ * Parameters:
+ * address       I2C address of the board
+ * registerIndex Index of the IS31FL3730 register to write to
+ * value         8-bit value for the register
+ */
+void GhostLab42Reboot::writeAddressRegister(byte address, byte registerIndex,
+                                            byte value)
+{
+  setupAddressTransmission(address);
+  Wire.write(registerIndex);
+  Wire.write(value);
+  endAddressTransmission();
+#if REBOOT_ENABLE_STATISTICS
+  busBytes += 2;
+#endif
+}
+
+/*
+ * Copies what the display shows to its mirrors. The mirrors are visited in
+ * channel order, starting from the end that is on the selected multiplexer
+ * channel, and mirrors that already show the same thing are skipped.
+ *
+ * Parameters:
+ * displayID Unique identifier for the display
+ * frame     Copy the segments as well as the settings
+ */
+void GhostLab42Reboot::syncMirrors(int displayID, bool frame)
+{
+  int first = -1;
+  int last = -1;
+
+  for (byte i = 0; i < mirrorCount; i++)
+  {
+    if (mirrorSource[i] != displayID) continue;
+    if (first == -1) first = i;
+    last = i;
+  }
+
+  if (first == -1) return;
+
+  if (mirrorChannel[last] == muxSelected &&
+      mirrorChannel[first] != muxSelected)
+  {
+    for (int i = last; i >= first; i--)
+    {
+      if (mirrorSource[i] == displayID) syncMirror(i, frame);
+    }
+  }
+  else
+  {
+    for (int i = first; i <= last; i++)
+    {
+      if (mirrorSource[i] == displayID) syncMirror(i, frame);
+    }
+  }
+}
+
+/*
+ * Sends a mirror the registers of its display that it does not have yet
+ *
+ * Parameters:
+ * mirror Index of the mirror
+ * frame  Copy the segments as well as the settings
+ */
+void GhostLab42Reboot::syncMirror(byte mirror, bool frame)
+{
+  byte displayID = mirrorSource[mirror];
+  byte address = mirrorAddress[mirror];
+  bool known = mirrorKnown[mirror];
+
+  // Span of digits that differ
+  int first = 0;
+  int last = digitCount(displayID) - 1;
+  if (frame == false)
+  {
+    last = -1;
+  }
+  else if (known)
+  {
+    while (first <= last &&
+           mirrorData[mirror][first] == registerData[displayID][first])
+    {
+      first++;
+    }
+    while (last >= first &&
+           mirrorData[mirror][last] == registerData[displayID][last])
+    {
+      last--;
+    }
+  }
+
+  bool configChanged = !known ||
+    mirrorConfig[mirror] != registerConfig[displayID];
+  bool pwmChanged = !known || mirrorPWM[mirror] != registerPWM[displayID];
+  bool currentChanged = !known ||
+    mirrorCurrent[mirror] != displayCurrent[displayID];
+  bool shutdown =
+    (registerConfig[displayID] & IS31FL3730_Configuration_Shutdown) != 0;
+
+  // Board already shows the same thing
+  if (first > last && !configChanged && !pwmChanged && !currentChanged)
+  {
+    return;
+  }
+
+  if (mirrorChannel[mirror] == -1) freeMainBusAddress(address);
+  else selectMuxChannel(mirrorChannel[mirror]);
+
+  // Make sure the maximum current for the board is not exceeded, even if the
+  // current did not change
+  writeAddressRegister(address, IS31FL3730_Lighting_Effect_Register,
+                       displayCurrent[displayID]);
+
+  // Shut down before anything else changes, but only turn back on once
+  // everything else is in place
+  if (configChanged && shutdown)
+  {
+    writeAddressRegister(address, IS31FL3730_Configuration_Register,
+                         registerConfig[displayID]);
+  }
+
+  if (first <= last)
+  {
+    setupAddressTransmission(address);
+    Wire.write(IS31FL3730_Data_Registers + first);
+    for (int i = first; i <= last; i++)
+    {
+      Wire.write(registerData[displayID][i]);
+    }
+    endAddressTransmission();
+#if REBOOT_ENABLE_STATISTICS
+    busBytes += 1 + (last - first + 1);
+#endif
+
+    writeAddressRegister(address, IS31FL3730_Update_Column_Register, 0x00);
+  }
+
+  if (pwmChanged)
+  {
+    writeAddressRegister(address, IS31FL3730_PWM_Register,
+                         registerPWM[displayID]);
+  }
+
+  if (configChanged && !shutdown)
+  {
+    writeAddressRegister(address, IS31FL3730_Configuration_Register,
+                         registerConfig[displayID]);
+  }
+
+  if (frame)
+  {
+    memcpy(mirrorData[mirror], registerData[displayID],
+           sizeof(mirrorData[mirror]));
+  }
+  mirrorPWM[mirror] = registerPWM[displayID];
+  mirrorConfig[mirror] = registerConfig[displayID];
+  mirrorCurrent[mirror] = displayCurrent[displayID];
+  mirrorKnown[mirror] = true;
+}
+
+/*
+ * Switches the I2C multiplexer to a channel, unless it is already on it
+ *
+ * Parameters:
+ * channel Channel of the multiplexer (0-7), or -1 for no channel
+ */
+void GhostLab42Reboot::selectMuxChannel(int channel)
+{
+  if (channel == muxSelected) return;
+
+  setupAddressTransmission(muxAddress);
+  Wire.write(channel == -1 ? 0x00 : (1 << channel));
+  endAddressTransmission();
+#if REBOOT_ENABLE_STATISTICS
+  busBytes += 1;
+#endif
+
+  muxSelected = channel;
+}
+
+/*
+ * Switches the I2C multiplexer off if a mirror on the selected channel has
+ * the same address as a board on the main bus that is about to be written to
+ *
+ * Parameters:
+ * address I2C address of the board on the main bus
+ */
+void GhostLab42Reboot::freeMainBusAddress(byte address)
+{
+  if (muxSelected == -1) return;
+
+  for (byte i = 0; i < mirrorCount; i++)
+  {
+    if (mirrorChannel[i] == muxSelected && mirrorAddress[i] == address)
+    {
+      selectMuxChannel(-1);
+      return;
+    }
+  }
+}
+#endif
+
+/*
+ * Converts a character into the appropriate bytes for display (gfedcba format)
+ * and returns the number of digits it takes up
+ *
+ * Parameters:
+ * font      Font to look the character up in
+ * character The character to be converted. Some characters like "W" need
+ *           multiple digits.
+ * decimal   Whether to add a decimal to the (last) digit
+ * cells     Receives the converted bytes, one for each digit
+ */
+byte GhostLab42Reboot::writeCharacter(const RebootFont *font, char character,
+                                      bool decimal, byte cells[])
+{
+  // Sometimes decimals are involved, so we need something to add it
+  byte decimalOffset = decimal ? 0x80 : 0x00;
+
+  for (; font != NULL; font = font->fallback)
+  {
+    // Most characters are a single lookup in the glyph table
+    byte index = (byte)character - (byte)font->first;
+    if (index < font->glyphCount)
+    {
+      byte glyph = readTable(font->glyphs, index);
+      if (glyph != REBOOT_GLYPH_EXTRA)
+      {
+        cells[0] = glyph | decimalOffset;
+        return 1;
+      }
+    }
+
+    // Characters that take up more than one digit, or fonts without a glyph
+    // table, need a search through the extra glyphs
+    for (byte i = 0; i < font->extraCount; i++)
+    {
+      if ((char)pgm_read_byte(&font->extras[i].character) != character)
+      {
+        continue;
+      }
+
+      RebootGlyph glyph;
+      memcpy_P(&glyph, &font->extras[i], sizeof(glyph));
+
+      if (glyph.width == 0) break;
+      if (glyph.width > REBOOT_GLYPH_CELLS) glyph.width = REBOOT_GLYPH_CELLS;
+
+      memcpy(cells, glyph.cells, glyph.width);
+      cells[glyph.width - 1] |= decimalOffset;
+      return glyph.width;
+    }
+  }
+
+  // Anything else turns into a blank for that character space
+  cells[0] = decimalOffset;
+  return 1;
+}
+
+/*
+ * Returns the start of a span for traceSpan(), or 0 when tracing is turned off
+ * so the time is not read for nothing
+ */
+unsigned long GhostLab42Reboot::traceStart()
+{
+#if REBOOT_TRACE_SPANS > 0
+  return clockMicros();
+#else
+  return 0;
+#endif
+}
+
+/*
+ * Records a span that ends now in the trace, overwriting the oldest span when
+ * the trace is full. Does nothing when tracing is turned off.
+ *
+ * Parameters:
+ * kind  RebootTraceKind of the span
+ * id    I2C address, display or group, depending on the kind
+ * start Start of the span, from traceStart()
+ */
+void GhostLab42Reboot::traceSpan(byte kind, byte id, unsigned long start)
+{
+#if REBOOT_TRACE_SPANS > 0
+  unsigned long duration = clockMicros() - start;
+
+  RebootTraceSpan &span = traceSpans[traceNext];
+  span.start = start;
+  span.duration = (duration > 0xFFFF) ? 0xFFFF : duration;
+  span.kind = kind;
+  span.id = id;
+
+  traceNext = (traceNext + 1) % REBOOT_TRACE_SPANS;
+  if (traceCount < REBOOT_TRACE_SPANS) traceCount++;
+  else traceDropped++;
+#endif
+}
+
+#if REBOOT_ENABLE_PRINT
+/******************************************************************************
+ *                              Print Interface                               *
+ ******************************************************************************/
+
+RebootDisplay::RebootDisplay()
+{
+  reboot = NULL;
+  displayID = 0;
+  cellCount = 0;
+  lastCharacter = 0;
+  lastCutOff = false;
+  lineAlignment = REBOOT_ALIGN_LEFT;
+}
+
+/*
+ * Converts a printed character and adds it to the line. A newline shows the
+ * line on the display, carriage returns are ignored. Characters that do not
+ * fit on the display are cut off.
+ *
+ * Parameters:
+ * character The character that was printed
+ */
+size_t RebootDisplay::write(uint8_t character)
+{
+  if (displayID >= REBOOT_DISPLAY_COUNT) return 1;
+
+  if (character == '\n')
+  {
+    flush();
+    return 1;
+  }
+
+  if (character == '\r') return 1;
+
+  // A decimal after a regular character is written as part of the character
+  if (character == '.' && lastCharacter != 0 && lastCharacter != '.')
+  {
+    if (lastCutOff == false) cells[cellCount - 1] |= 0x80;
+    lastCharacter = character;
+    return 1;
+  }
+
+  // Anything else is converted with the font of the display. A decimal at
+  // the start or after another decimal gets a digit of its own.
+  byte characterCells[REBOOT_GLYPH_CELLS];
+  byte width;
+
+  if (character == '.')
+  {
+    width = reboot->writeCharacter(reboot->currentFont(displayID), ' ', true,
+                                   characterCells);
+  }
+  else
+  {
+    width = reboot->writeCharacter(reboot->currentFont(displayID), character,
+                                   false, characterCells);
+  }
+
+  lastCharacter = character;
+  lastCutOff = (cellCount + width > digitCount(displayID));
+
+  for (byte i = 0; i < width && cellCount < digitCount(displayID); i++)
+  {
+    cells[cellCount] = characterCells[i];
+    cellCount++;
+  }
+
+  return 1;
+}
+
+/*
+ * Shows the line that was printed so far on the display and starts a new one
+ */
+void RebootDisplay::flush()
+{
+  if (displayID >= REBOOT_DISPLAY_COUNT) return;
+
+  reboot->showCells(displayID, cells, cellCount, lineAlignment);
+
+  cellCount = 0;
+  lastCharacter = 0;
+  lastCutOff = false;
+}
+
+/*
+ * Sets how printed lines are lined up on the display
+ *
+ * Parameters:
+ * alignment REBOOT_ALIGN_LEFT, REBOOT_ALIGN_RIGHT or REBOOT_ALIGN_CENTER
+ */
+void RebootDisplay::setAlignment(int alignment)
+{
+  lineAlignment = alignment;
+}
+#endif
+
+/******************************************************************************
+ *                                Manual Clock                                *
+ ******************************************************************************/
+
+RebootManualClock::RebootManualClock()
+{
+  milliseconds = 0;
+  microseconds = 0;
+}
+
+/*
+ * Returns the milliseconds the clock was moved forward by
+ */
+unsigned long RebootManualClock::millis()
+{
+  return milliseconds;
+}
+
+/*
+ * Returns the microseconds the clock was moved forward by, which wraps around
+ * like micros() does
+ */
+unsigned long RebootManualClock::micros()
+{
+  return milliseconds * 1000UL + microseconds;
+}
+
+/*
+ * Moves the clock forward instead of waiting
+ *
+ * Parameters:
+ * ms Milliseconds to move the clock forward by
+ */
+void RebootManualClock::delay(unsigned long ms)
+{
+  advance(ms);
+}
+
+/*
+ * Moves the clock forward
+ *
+ * Parameters:
+ * ms Milliseconds to move the clock forward by
+ */
+void RebootManualClock::advance(unsigned long ms)
+{
+  milliseconds += ms;
+}
+
+/*
+ * Moves the clock forward by less than a millisecond, or by any number of
+ * microseconds
+ *
+ * Parameters:
+ * us Microseconds to move the clock forward by
+ */
+void RebootManualClock::advanceMicros(unsigned long us)
+{
+  us += microseconds;
+  milliseconds += us / 1000;
+  microseconds = us % 1000;
 }
@@ -10,21 +10,618 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <stdarg.h>
+#include "GhostLab42RebootConfig.h"
+
+// Number of displays in the Reboot board set
+#define REBOOT_DISPLAY_COUNT 3
+
+// Number of digits on the largest display
+#define REBOOT_MAX_DIGITS 6
+
+// Number of brightness groups
+#define REBOOT_GROUP_COUNT 3
+
+// Returned by tick() when nothing is scheduled
+#define REBOOT_NO_DEADLINE 0xFFFFFFFFUL
+
+// Value in the glyph table of a font that sends the character to the list of
+// extra glyphs, for characters that take up more than one digit or are not in
+// the font at all
+#define REBOOT_GLYPH_EXTRA 0xFF
+
+// Character of a font that is not a single digit, or that belongs to a sparse
+// font without a glyph table
+struct RebootGlyph
+{
+  char character;                 // Character the glyph is for
+  byte width;                     // Number of digits the glyph takes up
+  byte cells[REBOOT_GLYPH_CELLS]; // Segment data (gfedcba format) per digit
+};
+
+// Font that converts characters into segment data. The glyph table and the
+// extra glyphs are stored in flash (PROGMEM). Characters that the font does
+// not have are looked up in the fallback font, and are left blank if no font
+// has them.
+struct RebootFont
+{
+  char first;                    // First character of the glyph table
+  byte glyphCount;               // Number of characters in the glyph table
+  const byte *glyphs;            // Segment data for each character, or
+                                 // REBOOT_GLYPH_EXTRA (in flash)
+  byte extraCount;               // Number of extra glyphs
+  const RebootGlyph *extras;     // Extra glyphs (in flash)
+  const RebootFont *fallback;    // Font for the other characters, or NULL
+};
+
+// Font the displays start with (0-9, A-Z, and some punctuation)
+extern const RebootFont rebootDefaultFont;
+
+// Extra glyphs that tell apart characters that look the same with the default
+// font (like H, K and X, or S and 5), with the default font as fallback
+extern const RebootFont rebootAlternateFont;
+
+// Segment transition effects
+enum RebootTransitionEffect
+{
+  REBOOT_WIPE_LEFT_TO_RIGHT, // New characters replace old ones from the left
+  REBOOT_WIPE_TOP_DOWN,      // New segments replace old ones from the top
+  REBOOT_DISSOLVE,           // Segments switch over in a scattered order
+  REBOOT_MORPH               // Each digit changes one segment at a time
+};
+
+// Ways characters can be lined up on a display
+enum RebootAlignment
+{
+  REBOOT_ALIGN_LEFT,
+  REBOOT_ALIGN_RIGHT,
+  REBOOT_ALIGN_CENTER
+};
+
+// What happens to characters that do not fit on a display
+enum RebootOverflow
+{
+  REBOOT_OVERFLOW_TRUNCATE, // Cut off
+  REBOOT_OVERFLOW_ELLIPSIS  // Cut off, with a decimal where they were cut off
+};
+
+// Ways a display can be mounted
+enum RebootOrientation
+{
+  REBOOT_ORIENTATION_NORMAL, // As designed
+  REBOOT_ROTATE_180,         // Upside down
+  REBOOT_MIRROR_HORIZONTAL,  // Seen from the back, or in a mirror
+  REBOOT_MIRROR_VERTICAL     // Upside down in a mirror
+};
+
+// Builds a 256 byte segment map for setSegmentMap() at compile time. Each
+// argument is the bit (0-7) of the data register that lights that segment,
+// for example REBOOT_SEGMENT_MAP(0, 1, 2, 3, 4, 5, 6, 7) is the gfedcba layout
+// of the Reboot displays. Store the map in flash:
+// const byte myWiring[256] PROGMEM = REBOOT_SEGMENT_MAP(7, 6, 5, 4, 3, 2, 1, 0);
+#define REBOOT_SEGMENT_MAP(a, b, c, d, e, f, g, dp) \
+  { REBOOT_SEGMENT_MAP_64_(0, a, b, c, d, e, f, g, dp), \
+    REBOOT_SEGMENT_MAP_64_(64, a, b, c, d, e, f, g, dp), \
+    REBOOT_SEGMENT_MAP_64_(128, a, b, c, d, e, f, g, dp), \
+    REBOOT_SEGMENT_MAP_64_(192, a, b, c, d, e, f, g, dp) }
+#define REBOOT_SEGMENT_MAP_64_(n, ...) \
+  REBOOT_SEGMENT_MAP_16_(n, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_16_(n + 16, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_16_(n + 32, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_16_(n + 48, __VA_ARGS__)
+#define REBOOT_SEGMENT_MAP_16_(n, ...) \
+  REBOOT_SEGMENT_MAP_4_(n, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_4_(n + 4, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_4_(n + 8, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_4_(n + 12, __VA_ARGS__)
+#define REBOOT_SEGMENT_MAP_4_(n, ...) \
+  REBOOT_SEGMENT_MAP_1_(n, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_1_(n + 1, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_1_(n + 2, __VA_ARGS__), \
+  REBOOT_SEGMENT_MAP_1_(n + 3, __VA_ARGS__)
+#define REBOOT_SEGMENT_MAP_1_(n, a, b, c, d, e, f, g, dp) \
+  (byte)(((((n) >> 0) & 1) << (a)) | ((((n) >> 1) & 1) << (b)) | \
+         ((((n) >> 2) & 1) << (c)) | ((((n) >> 3) & 1) << (d)) | \
+         ((((n) >> 4) & 1) << (e)) | ((((n) >> 5) & 1) << (f)) | \
+         ((((n) >> 6) & 1) << (g)) | ((((n) >> 7) & 1) << (dp)))
+
+// Power states that are tracked for each display
+enum RebootPowerState
+{
+  REBOOT_POWER_ON,      // Display is lit
+  REBOOT_POWER_BLANKED, // Display was turned off with blank() or blink()
+  REBOOT_POWER_IDLE,    // Display was shut down by the idle timeout
+  REBOOT_POWER_STATE_COUNT
+};
+
+// Kinds of spans that are recorded in the trace
+enum RebootTraceKind
+{
+  REBOOT_TRACE_TRANSACTION,     // I2C transaction (ID is the I2C address)
+  REBOOT_TRACE_COMMIT,          // Frame sent to a display (ID is the display)
+  REBOOT_TRACE_TICK,            // Call of tick()
+  REBOOT_TRACE_TRANSITION_STEP, // Transition step (ID is the display)
+  REBOOT_TRACE_FADE_STEP,       // Group fade step (ID is the group)
+  REBOOT_TRACE_SCROLL_STEP,     // Canvas scroll step
+  REBOOT_TRACE_FRAME,           // Frame of the frame clock (ID is the number
+                                // of frames that were skipped)
+  REBOOT_TRACE_BLINK,           // Blink turning a display on or off (ID is
+                                // the display)
+  REBOOT_TRACE_IDLE,            // Idle timeout shutting a display down (ID is
+                                // the display)
+  REBOOT_TRACE_AUTO_BRIGHTNESS  // Light sensor sample
+};
+
+// Span of time in the trace
+struct RebootTraceSpan
+{
+  unsigned long start;   // Start, from micros() of the clock
+  unsigned int duration; // Length in microseconds (at most 65535)
+  byte kind;             // RebootTraceKind
+  byte id;               // I2C address, display or group, depending on kind
+};
+
+// Source of time for the library, see GhostLab42Reboot::setClock(). Without
+// one the library reads millis() and micros() from Arduino.
+class RebootClock
+{
+  public:
+    virtual unsigned long millis() = 0;
+    virtual unsigned long micros() = 0;
+    virtual void delay(unsigned long ms) = 0;
+};
+
+// Clock that only moves when it is told to, so a test on a computer can run
+// seconds of animation in an instant. delay() moves it forward as well.
+class RebootManualClock : public RebootClock
+{
+  public:
+    RebootManualClock();
+    virtual unsigned long millis();
+    virtual unsigned long micros();
+    virtual void delay(unsigned long ms);
+    void advance(unsigned long ms);
+    void advanceMicros(unsigned long us);
+  private:
+    unsigned long milliseconds;
+    unsigned int microseconds; // Microseconds past the millisecond (0-999)
+};
+
+#if REBOOT_ENABLE_PRINT
+class GhostLab42Reboot;
+
+// Print interface of a single display, see GhostLab42Reboot::display().
+// Characters are converted as they are printed and kept until the line is
+// finished with a newline or flush().
+class RebootDisplay : public Print
+{
+  public:
+    RebootDisplay();
+    virtual size_t write(uint8_t character);
+    using Print::write;
+    void flush();
+    void setAlignment(int alignment);
+  private:
+    friend class GhostLab42Reboot;
+
+    GhostLab42Reboot *reboot;
+    byte displayID;
+
+    // Segment data of the line so far
+    byte cells[REBOOT_MAX_DIGITS];
+    byte cellCount;
+
+    // Last character of the line (0 at the start), and whether it was cut off
+    char lastCharacter;
+    bool lastCutOff;
+
+    byte lineAlignment;
+};
+#endif
 
 class GhostLab42Reboot
 {
+#if REBOOT_ENABLE_PRINT
+  friend class RebootDisplay;
+#endif
+
   public:
     GhostLab42Reboot();
     void begin();
     void write(int displayID, String value);
+    void write(int displayID, String value, int alignment,
+               int overflow = REBOOT_OVERFLOW_TRUNCATE);
+    int getTextWidth(int displayID, String value);
+#if REBOOT_ENABLE_PRINT
+    RebootDisplay &display(int displayID);
+    int printf(int displayID, const char *format, ...);
+    int printf(int displayID, const __FlashStringHelper *format, ...);
+#endif
+    unsigned long getFrameCacheHits();
+    unsigned long getFrameCacheMisses();
     void resetDisplay(int displayID);
     void setDisplayBrightness (int displayID, int brightness);
+    void blank(int displayID);
+    void unblank(int displayID);
+#if REBOOT_ENABLE_BLINK
+    void blink(int displayID, unsigned long periodMs, int duty);
+#endif
+    unsigned long tick();
+    void sleep(unsigned long durationMs);
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+    void setIdleTimeout(unsigned long timeoutMs);
+#endif
+    unsigned long getDisplayPowerTime(int displayID, int state);
+#if REBOOT_ENABLE_CURRENT_BUDGET
+    void setCurrentBudget(unsigned int milliamps);
+#endif
+    unsigned int getEstimatedCurrent();
+    bool setDisplayCurrent(int displayID, int milliamps);
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+    void setAutoBrightness(int pin, int darkReading, int brightReading,
+                           int minBrightness, int maxBrightness);
+    void setAutoBrightnessFilter(unsigned long sampleIntervalMs, int samples,
+                                 int smoothing, int threshold);
+#endif
+#if REBOOT_ENABLE_GROUPS
+    void setBrightnessGroup(int groupID, int displayID, int scale);
+    void removeFromBrightnessGroup(int groupID, int displayID);
+    void setGroupBrightness(int groupID, int brightness);
+    void fadeGroupBrightness(int groupID, int brightness,
+                             unsigned long durationMs);
+#endif
+#if REBOOT_ENABLE_TRANSITIONS
+    void crossfade(int displayID, String value, unsigned long durationMs);
+    void setCrossfadeOptions(unsigned long subframeMs, unsigned int busBudget);
+    void transition(int displayID, String value, int effect,
+                    unsigned long durationMs);
+    unsigned long getTransitionBusBytes(int displayID);
+    unsigned long getTransitionBusTransactions(int displayID);
+#endif
+#if REBOOT_ENABLE_CANVAS
+    void setCanvasOrder(int first, int second, int third);
+    void writeCanvas(String value, int alignment = REBOOT_ALIGN_LEFT,
+                     int overflow = REBOOT_OVERFLOW_TRUNCATE);
+#endif
+#if REBOOT_ENABLE_SCROLL
+    int scrollCanvas(String value, unsigned long stepMs, bool repeat);
+    bool isCanvasScrolling();
+#endif
+#if REBOOT_MIRROR_COUNT > 0
+    bool addMirror(int displayID, byte address, int muxChannel);
+    void removeMirrors(int displayID);
+    void setMuxAddress(byte address);
+#endif
+#if REBOOT_ENABLE_ORIENTATION
+    void setDisplayOrientation(int displayID, int orientation);
+    void setSegmentMap(int displayID, const byte *segmentTable);
+#endif
+#if REBOOT_ENABLE_FONTS
+    void setDisplayFont(int displayID, const RebootFont *font);
+#if REBOOT_ENABLE_CANVAS
+    void setCanvasFont(const RebootFont *font);
+#endif
+#endif
+    void dumpTrace(Print &out);
+#if REBOOT_ENABLE_CLOCK
+    void setClock(RebootClock *clock);
+#endif
+#if REBOOT_FRAME_CLOCK > 0
+    bool startFrameClock(unsigned long periodUs);
+    void stopFrameClock();
+    bool isFrameDue();
+    unsigned long getMissedFrames();
+#endif
   private:
+    // Copy of the segment data each display is showing, one byte per digit
+    byte frameBuffer[REBOOT_DISPLAY_COUNT][REBOOT_MAX_DIGITS];
+
+#if REBOOT_ENABLE_PRINT
+    // Print interfaces of the displays, plus one that ignores everything for
+    // display IDs that do not exist
+    RebootDisplay printDisplays[REBOOT_DISPLAY_COUNT + 1];
+#endif
+
+#if REBOOT_ENABLE_CLOCK
+    // Clock set with setClock(), or NULL for millis() and micros()
+    RebootClock *timeSource;
+#endif
+
+#if REBOOT_FRAME_CACHE > 0
+    // Frames that were converted by write(), found by a hash of the
+    // characters along with their length, the font and the number of digits,
+    // and the last time each was used (0 for an empty place)
+    unsigned long cacheHash[REBOOT_FRAME_CACHE];
+    unsigned int cacheLength[REBOOT_FRAME_CACHE];
+    const RebootFont *cacheFont[REBOOT_FRAME_CACHE];
+    byte cacheDigits[REBOOT_FRAME_CACHE];
+    byte cacheCellCount[REBOOT_FRAME_CACHE];
+    byte cacheCells[REBOOT_FRAME_CACHE][REBOOT_MAX_DIGITS];
+    unsigned long cacheLastUse[REBOOT_FRAME_CACHE];
+    unsigned long cacheUses;
+#endif
+#if REBOOT_ENABLE_STATISTICS && REBOOT_FRAME_CACHE > 0
+    unsigned long cacheHits;
+    unsigned long cacheMisses;
+#endif
+
+#if REBOOT_ENABLE_FONTS
+    // Font each display and the canvas convert characters with
+    const RebootFont *displayFont[REBOOT_DISPLAY_COUNT];
+#if REBOOT_ENABLE_CANVAS
+    const RebootFont *canvasFont;
+#endif
+#endif
+
+#if REBOOT_ENABLE_ORIENTATION
+    // Segment map (in flash) from the gfedcba layout to the wiring of each
+    // display, NULL for no change, and whether the digits are in reverse order
+    const byte *segmentMap[REBOOT_DISPLAY_COUNT];
+    bool reverseColumns[REBOOT_DISPLAY_COUNT];
+#endif
+
+    // Span of digits in the frame buffer that changed since it was last sent
+    // to the display (nothing changed when dirtyFirst > dirtyLast)
+    byte dirtyFirst[REBOOT_DISPLAY_COUNT];
+    byte dirtyLast[REBOOT_DISPLAY_COUNT];
+
+    // PWM register value for the brightness each display was set to
+    byte displayPWM[REBOOT_DISPLAY_COUNT];
+
+    // Current setting each display was set to with setDisplayCurrent()
+    byte displayMaxCurrent[REBOOT_DISPLAY_COUNT];
+
+    // PWM register and current setting values each display is using, which
+    // are lower than requested when the current budget is exceeded
+    byte outputPWM[REBOOT_DISPLAY_COUNT];
+    byte displayCurrent[REBOOT_DISPLAY_COUNT];
+
+#if REBOOT_ENABLE_CURRENT_BUDGET
+    // Current budget for all displays together, 0 means no budget
+    unsigned int currentBudget;
+    byte targetPWM[REBOOT_DISPLAY_COUNT];
+    byte targetCurrent[REBOOT_DISPLAY_COUNT];
+#endif
+
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+    // Automatic brightness from an analog light sensor, a pin of -1 means it
+    // is turned off
+    int autoBrightnessPin;
+    int autoBrightnessDark;
+    int autoBrightnessBright;
+    byte autoBrightnessMin;
+    byte autoBrightnessMax;
+    unsigned long autoBrightnessInterval;
+    unsigned long autoBrightnessLastSample;
+    byte autoBrightnessSamples;
+    byte autoBrightnessSmoothing;
+    byte autoBrightnessThreshold;
+    bool autoBrightnessPrimed;
+    long autoBrightnessFiltered;
+    byte autoBrightnessOutput;
+#endif
+
+#if REBOOT_ENABLE_GROUPS
+    // Brightness groups, each display is a member when its bit is set
+    byte groupMembers[REBOOT_GROUP_COUNT];
+    byte groupScale[REBOOT_GROUP_COUNT][REBOOT_DISPLAY_COUNT];
+    byte groupLevel[REBOOT_GROUP_COUNT];
+
+    // Group fades, a duration of 0 means the group is not fading
+    byte groupFadeFrom[REBOOT_GROUP_COUNT];
+    byte groupFadeTo[REBOOT_GROUP_COUNT];
+    unsigned long groupFadeStart[REBOOT_GROUP_COUNT];
+    unsigned long groupFadeDuration[REBOOT_GROUP_COUNT];
+#endif
+
+#if REBOOT_ENABLE_STATISTICS
+    // Number of I2C transactions and bytes (including the address byte) sent
+    // to all displays
+    unsigned long busTransactions;
+    unsigned long busBytes;
+#endif
+
+#if REBOOT_TRACE_SPANS > 0
+    // Ring of the last spans that were recorded, the next place to record a
+    // span in, the number of spans in the ring and the number of spans that
+    // were overwritten before they were dumped
+    RebootTraceSpan traceSpans[REBOOT_TRACE_SPANS];
+    unsigned int traceNext;
+    unsigned int traceCount;
+    unsigned long traceDropped;
+
+    // Start and I2C address of the transaction being set up
+    unsigned long transactionStart;
+    byte transactionAddress;
+#endif
+
+#if REBOOT_FRAME_CLOCK > 0
+    // Time between frames of the frame clock in microseconds (0 when it is
+    // stopped), the micros() the next frame is due at when no hardware timer
+    // is used, and the number of frames that were skipped
+    unsigned long frameClockPeriod;
+    unsigned long frameClockNext;
+    unsigned long missedFrames;
+#endif
+
+#if REBOOT_ENABLE_TRANSITIONS
+    // Transitions between the frame a display was showing and the new frame
+    // in the frame buffer
+    unsigned long crossfadeSubframe;
+    unsigned int crossfadeBusBudget;
+    byte transitionMode[REBOOT_DISPLAY_COUNT];
+    byte transitionFrom[REBOOT_DISPLAY_COUNT][REBOOT_MAX_DIGITS];
+    byte transitionFirstColumn[REBOOT_DISPLAY_COUNT];
+    byte transitionColumnCount[REBOOT_DISPLAY_COUNT];
+    bool transitionShowingNew[REBOOT_DISPLAY_COUNT];
+    unsigned int transitionAccumulator[REBOOT_DISPLAY_COUNT];
+    unsigned long transitionStart[REBOOT_DISPLAY_COUNT];
+    unsigned long transitionDuration[REBOOT_DISPLAY_COUNT];
+    unsigned long transitionInterval[REBOOT_DISPLAY_COUNT];
+    unsigned long transitionLastStep[REBOOT_DISPLAY_COUNT];
+#if REBOOT_ENABLE_STATISTICS
+    unsigned long transitionBytes[REBOOT_DISPLAY_COUNT];
+    unsigned long transitionTransactions[REBOOT_DISPLAY_COUNT];
+#endif
+
+    // Precomputed segment transition steps, each entry is a digit (with the
+    // top bit set on the last digit of a step) and its new segments
+    byte transitionDeltas[REBOOT_DISPLAY_COUNT][REBOOT_TRANSITION_DELTAS][2];
+    byte transitionDeltaCount[REBOOT_DISPLAY_COUNT];
+    byte transitionDeltaIndex[REBOOT_DISPLAY_COUNT];
+#endif
+
+#if REBOOT_ENABLE_CANVAS
+    // Displays that make up the canvas from left to right (-1 for an unused
+    // place) and the number of digits on the canvas
+    signed char canvasOrder[REBOOT_DISPLAY_COUNT];
+    byte canvasLength;
+#endif
+
+#if REBOOT_ENABLE_SCROLL
+    // Message scrolling across the canvas, already converted to segment data
+    byte scrollCells[REBOOT_SCROLL_CELLS];
+    int scrollLength;
+    int scrollOffset;
+    bool scrollRepeat;
+    bool scrolling;
+    unsigned long scrollInterval;
+    unsigned long scrollLastStep;
+#endif
+
+#if REBOOT_MIRROR_COUNT > 0
+    // Registers of each display as they were last written (data registers,
+    // PWM Register and Configuration Register), which the mirrors copy
+    byte registerData[REBOOT_DISPLAY_COUNT][REBOOT_MAX_DIGITS];
+    byte registerPWM[REBOOT_DISPLAY_COUNT];
+    byte registerConfig[REBOOT_DISPLAY_COUNT];
+
+    // Boards that show a copy of one of the displays, sorted by mux channel
+    // (-1 for a board that is not behind the mux), with the registers each
+    // board was last sent
+    byte mirrorCount;
+    byte mirrorSource[REBOOT_MIRROR_COUNT];
+    byte mirrorAddress[REBOOT_MIRROR_COUNT];
+    signed char mirrorChannel[REBOOT_MIRROR_COUNT];
+    byte mirrorData[REBOOT_MIRROR_COUNT][REBOOT_MAX_DIGITS];
+    byte mirrorPWM[REBOOT_MIRROR_COUNT];
+    byte mirrorConfig[REBOOT_MIRROR_COUNT];
+    byte mirrorCurrent[REBOOT_MIRROR_COUNT];
+    bool mirrorKnown[REBOOT_MIRROR_COUNT];
+
+    // I2C multiplexer in front of the mirrors and its selected channel (-1 for
+    // none)
+    byte muxAddress;
+    signed char muxSelected;
+#endif
+
+    // Software shutdown state of each display
+    bool displayBlanked[REBOOT_DISPLAY_COUNT];
+
+#if REBOOT_ENABLE_IDLE_TIMEOUT
+    // Idle power management, a timeout of 0 means displays never go idle
+    unsigned long idleTimeout;
+    unsigned long lastActivity[REBOOT_DISPLAY_COUNT];
+    bool displayAsleep[REBOOT_DISPLAY_COUNT];
+#endif
+
+#if REBOOT_ENABLE_STATISTICS
+    // Time spent in each power state, for battery planning
+    byte powerState[REBOOT_DISPLAY_COUNT];
+    unsigned long powerStateSince[REBOOT_DISPLAY_COUNT];
+    unsigned long powerStateTime[REBOOT_DISPLAY_COUNT][REBOOT_POWER_STATE_COUNT];
+#endif
+
+#if REBOOT_ENABLE_BLINK
+    // Blink effect settings, a period of 0 means the display is not blinking
+    unsigned long blinkPeriod[REBOOT_DISPLAY_COUNT];
+    unsigned long blinkOnTime[REBOOT_DISPLAY_COUNT];
+    unsigned long blinkStart[REBOOT_DISPLAY_COUNT];
+#endif
+
     bool verifyDisplayID(int displayID);
-    void setDisplayPowerMin(int displayID);
-    void setDisplayPowerMax(int displayID);
+    unsigned long clockMillis();
+    unsigned long clockMicros();
+    void setDisplayShutdown(int displayID, bool shutdown);
+    void applyDisplayShutdown(int displayID);
+    void updatePowerState(int displayID);
+    void markActivity(int displayID);
+    void wakeDisplay(int displayID);
+    bool displayIdle(int displayID);
+    bool displayBlinking(int displayID);
+    bool drawsCurrent(int displayID);
+    unsigned long estimateCurrent(int displayID, byte pwm, byte current);
+#if REBOOT_ENABLE_CURRENT_BUDGET
+    void updateCurrentBudget();
+#endif
+    void applyCurrentBudget(bool increases);
+    void writeDisplayOutput(int displayID, bool force);
+    void beginCurrentChange();
+    void endCurrentChange();
+    unsigned long nextDeadline();
+#if REBOOT_ENABLE_AUTO_BRIGHTNESS
+    void updateAutoBrightness();
+#endif
+#if REBOOT_ENABLE_GROUPS
+    bool verifyGroupID(int groupID);
+    void applyGroupBrightness(int groupID, int brightness);
+#endif
+    const RebootFont *currentFont(int displayID);
+    void encodeFrame(int displayID, String value);
+    int encodeCells(const RebootFont *font, const char *text, byte cells[],
+                    int maxCells, int skip);
+    int cacheEncodeCells(const RebootFont *font, const char *text,
+                         byte cells[], int maxCells);
+    void layoutCells(const RebootFont *font, const char *text, byte cells[],
+                     int cellCount, int alignment, int overflow);
+#if REBOOT_ENABLE_PRINT
+    void showCells(int displayID, const byte cells[], int cellCount,
+                   int alignment);
+    int formatText(Print &out, const char *format, bool formatInFlash,
+                   va_list args);
+#endif
+    void setCell(int displayID, byte column, byte segments);
+    byte mapSegments(int displayID, byte segments);
+#if REBOOT_ENABLE_ORIENTATION
+    void clearFrame(int displayID);
+#endif
+    void clearDirty(int displayID);
+    void commitFrame(int displayID);
+    void sendFrame(int displayID, int firstColumn, int columnCount);
+    void writeColumns(int displayID, const byte frame[], int firstColumn,
+                      int columnCount);
+    void updateColumns(int displayID);
+    bool transitionRunning(int displayID);
+#if REBOOT_ENABLE_TRANSITIONS
+    bool beginTransition(int displayID, String value,
+                         unsigned long durationMs, byte mode);
+    byte segmentTransitionSteps(int displayID, int effect);
+    byte segmentTransitionFrame(int displayID, int effect, byte column,
+                                byte step, byte steps);
+    void stepTransition(int displayID, unsigned long now);
+    void finishTransition(int displayID);
+#endif
+    void refreshDisplayCurrent(int displayID);
     void setupWireTransmission(int displayID);
-    void writeCharacter(char displayCharacters[]);
+    void setupAddressTransmission(byte address);
+    void endAddressTransmission();
+    void writeRegister(int displayID, byte registerIndex, byte value);
+#if REBOOT_MIRROR_COUNT > 0
+    void writeAddressRegister(byte address, byte registerIndex, byte value);
+    void syncMirrors(int displayID, bool frame);
+    void syncMirror(byte mirror, bool frame);
+    void selectMuxChannel(int channel);
+    void freeMainBusAddress(byte address);
+#endif
+    byte writeCharacter(const RebootFont *font, char character, bool decimal,
+                        byte cells[]);
+#if REBOOT_ENABLE_CANVAS
+    void drawCanvas(const byte cells[], int cellCount, int offset);
+    void commitCanvas();
+    const RebootFont *currentCanvasFont();
+#endif
+    unsigned long traceStart();
+    void traceSpan(byte kind, byte id, unsigned long start);
 };
 
 #endif
@@ -0,0 +1,143 @@
+/*
+ * Compile time settings of the GhostLab42Reboot library
+ *
+ * The settings are read by both the library and the sketch, so they have to
+ * be changed here (or passed to the compiler as build flags), not with a
+ * #define in the sketch. Features that are turned off take up no flash and no
+ * memory, and their functions are left out of the library.
+ *
+ * See documentation/developer/footprint.md for what each feature costs
+ */
+
+#ifndef GhostLab42RebootConfig_h
+#define GhostLab42RebootConfig_h
+
+/******************************************************************************
+ *                                  Features                                  *
+ ******************************************************************************/
+
+// display() and printf()
+#ifndef REBOOT_ENABLE_PRINT
+#define REBOOT_ENABLE_PRINT 1
+#endif
+
+// blink()
+#ifndef REBOOT_ENABLE_BLINK
+#define REBOOT_ENABLE_BLINK 1
+#endif
+
+// setIdleTimeout()
+#ifndef REBOOT_ENABLE_IDLE_TIMEOUT
+#define REBOOT_ENABLE_IDLE_TIMEOUT 1
+#endif
+
+// setCurrentBudget(). Displays always use the brightness and current they
+// were set to when it is turned off.
+#ifndef REBOOT_ENABLE_CURRENT_BUDGET
+#define REBOOT_ENABLE_CURRENT_BUDGET 1
+#endif
+
+// setCanvasOrder() and writeCanvas(), which scrollCanvas() needs as well
+#ifndef REBOOT_ENABLE_CANVAS
+#define REBOOT_ENABLE_CANVAS 1
+#endif
+
+// setDisplayOrientation() and setSegmentMap()
+#ifndef REBOOT_ENABLE_ORIENTATION
+#define REBOOT_ENABLE_ORIENTATION 1
+#endif
+
+// setDisplayFont() and setCanvasFont(). Every display uses the default font
+// when it is turned off.
+#ifndef REBOOT_ENABLE_FONTS
+#define REBOOT_ENABLE_FONTS 1
+#endif
+
+// setClock(). The library always reads millis() and micros() when it is
+// turned off.
+#ifndef REBOOT_ENABLE_CLOCK
+#define REBOOT_ENABLE_CLOCK 1
+#endif
+
+// crossfade(), transition(), setCrossfadeOptions(), getTransitionBusBytes()
+// and getTransitionBusTransactions()
+#ifndef REBOOT_ENABLE_TRANSITIONS
+#define REBOOT_ENABLE_TRANSITIONS 1
+#endif
+
+// scrollCanvas() and isCanvasScrolling(), off along with the canvas
+#ifndef REBOOT_ENABLE_SCROLL
+#define REBOOT_ENABLE_SCROLL REBOOT_ENABLE_CANVAS
+#endif
+
+// setAutoBrightness() and setAutoBrightnessFilter()
+#ifndef REBOOT_ENABLE_AUTO_BRIGHTNESS
+#define REBOOT_ENABLE_AUTO_BRIGHTNESS 1
+#endif
+
+// setBrightnessGroup(), removeFromBrightnessGroup(), setGroupBrightness() and
+// fadeGroupBrightness()
+#ifndef REBOOT_ENABLE_GROUPS
+#define REBOOT_ENABLE_GROUPS 1
+#endif
+
+// Counting for getDisplayPowerTime(), getFrameCacheHits(),
+// getFrameCacheMisses(), getTransitionBusBytes() and
+// getTransitionBusTransactions(), which return 0 when it is turned off
+#ifndef REBOOT_ENABLE_STATISTICS
+#define REBOOT_ENABLE_STATISTICS 1
+#endif
+
+/******************************************************************************
+ *                                   Sizes                                    *
+ ******************************************************************************/
+
+// Number of digit changes a segment transition can hold for each display
+#ifndef REBOOT_TRANSITION_DELTAS
+#define REBOOT_TRANSITION_DELTAS 32
+#endif
+
+// Number of digits a message scrolled across the canvas can hold
+#ifndef REBOOT_SCROLL_CELLS
+#define REBOOT_SCROLL_CELLS 32
+#endif
+
+// Most digits a single character of a font can take up
+#ifndef REBOOT_GLYPH_CELLS
+#define REBOOT_GLYPH_CELLS 3
+#endif
+
+// Number of converted frames that write() keeps, so that writing the same
+// characters again skips converting them. 0 turns the cache off.
+#ifndef REBOOT_FRAME_CACHE
+#define REBOOT_FRAME_CACHE 0
+#endif
+
+// Number of extra boards that can mirror the displays. 0 turns mirroring off,
+// along with addMirror(), removeMirrors() and setMuxAddress().
+#ifndef REBOOT_MIRROR_COUNT
+#define REBOOT_MIRROR_COUNT 4
+#endif
+
+// Number of spans the trace keeps, 0 turns tracing off
+#ifndef REBOOT_TRACE_SPANS
+#define REBOOT_TRACE_SPANS 0
+#endif
+
+/******************************************************************************
+ *                                Frame Clock                                 *
+ ******************************************************************************/
+
+// Hardware timer behind startFrameClock() on AVR boards, 1 for Timer1 or 2
+// for Timer2. Other boards (and other values) time the frames with micros().
+// 0 leaves the frame clock out and the timers free for other libraries:
+// Servo uses Timer1 and tone() uses Timer2.
+#ifndef REBOOT_FRAME_CLOCK
+#define REBOOT_FRAME_CLOCK 0
+#endif
+
+#if REBOOT_ENABLE_SCROLL && !REBOOT_ENABLE_CANVAS
+#error "REBOOT_ENABLE_SCROLL needs REBOOT_ENABLE_CANVAS"
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+void setup()
+{
+  reboot.begin();
+
+  // Label on the smaller four digit display, centered
+  reboot.write(1, "Fuel", REBOOT_ALIGN_CENTER);
+}
+
+void loop()
+{
+  for (int i = 0; i <= 1000; i += 7)
+  {
+    // Right aligned like a meter, no need to pad the number with spaces
+    // The decimal does not take up a digit of its own
+    reboot.write(2, String(i / 10.0, 1), REBOOT_ALIGN_RIGHT);
+
+    // Long messages get cut off with an ellipsis
+    if (i < 100) reboot.write(0, "Low Fuel", REBOOT_ALIGN_LEFT, REBOOT_OVERFLOW_ELLIPSIS);
+    else reboot.write(0, "Ok", REBOOT_ALIGN_CENTER);
+
+    delay(100);
+  }
+}
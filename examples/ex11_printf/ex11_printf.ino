@@ -0,0 +1,55 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// Number of writes to time
+const int runs = 200;
+
+void setup()
+{
+  Serial.begin(9600);
+  reboot.begin();
+
+  unsigned long start;
+  char buffer[8];
+
+  // Time the formatter of the library
+  start = micros();
+  for (int i = 0; i < runs; i++)
+  {
+    reboot.printf(0, "%3d.%1d", i / 10, i % 10);
+  }
+  unsigned long printfTime = micros() - start;
+
+  // Time the C library formatter with a write
+  start = micros();
+  for (int i = 0; i < runs; i++)
+  {
+    snprintf(buffer, sizeof(buffer), "%3d.%1d", i / 10, i % 10);
+    reboot.write(0, buffer);
+  }
+  unsigned long snprintfTime = micros() - start;
+
+  // Both include the time the I2C bus takes to send the digits that changed
+  Serial.print("reboot.printf():          ");
+  Serial.print(printfTime / runs);
+  Serial.println(" us per write");
+  Serial.print("snprintf() and write():   ");
+  Serial.print(snprintfTime / runs);
+  Serial.println(" us per write");
+
+  // To compare the flash used, compile the sketch with only one of the two
+  // loops above and compare the program size the IDE reports
+}
+
+void loop()
+{
+  // Status codes in hexadecimal, with the format stored in flash
+  for (unsigned int code = 0; code < 0x100; code++)
+  {
+    reboot.printf(1, F("E%02X"), code);
+    reboot.printf(2, "%4u", code);
+    delay(250);
+  }
+}
@@ -0,0 +1,228 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// Number of calls to time for each function
+const int runs = 100;
+
+// Time between frames in the loop jitter test, like the examples use
+const unsigned long framePeriodMs = 20;
+
+// I2C bus speeds to time everything at
+const unsigned long clocks[] = {100000, 400000};
+
+// Whole numbers from ex1, every digit changes from one to the next
+const char *numbers[2][3] =
+{
+  {"9146431", "1923", "5678"},
+  {"1709752", "8210", "4251"}
+};
+
+// Shortest, longest and total time of the calls timed so far, in
+// microseconds
+unsigned long minTime;
+unsigned long maxTime;
+unsigned long totalTime;
+int timeCount;
+
+void setup()
+{
+  Serial.begin(9600);
+  reboot.begin();
+
+  // Every line is comma separated, so the output can be saved and compared
+  // between versions of the library. per_second is 1000000 / mean_us, which
+  // is the frames per second for the frame and jitter lines.
+  Serial.println(F("kind,clock_hz,name,count,min_us,mean_us,max_us,per_second"));
+
+  for (unsigned int c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+  {
+    // Wire.begin() in reboot.begin() sets the bus speed back to 100kHz, so
+    // the bus speed is set after it
+    Wire.setClock(clocks[c]);
+    reboot.resetDisplay(0);
+    reboot.resetDisplay(1);
+    reboot.resetDisplay(2);
+
+    timeLatency(clocks[c]);
+    timeFrames(clocks[c]);
+    timeJitter(clocks[c]);
+#if REBOOT_FRAME_CLOCK > 0
+    timeFrameClock(clocks[c]);
+#endif
+  }
+
+  Serial.println(F("done"));
+}
+
+void loop()
+{
+}
+
+// Time single calls of each function
+void timeLatency(unsigned long clock)
+{
+  unsigned long start;
+
+  // Every digit changes
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    start = micros();
+    reboot.write(0, numbers[i % 2][0]);
+    addTime(micros() - start);
+  }
+  printTimes(F("latency"), clock, F("write"));
+
+  // Nothing changes, so only the current setting is sent
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    start = micros();
+    reboot.write(0, numbers[0][0]);
+    addTime(micros() - start);
+  }
+  printTimes(F("latency"), clock, F("write_unchanged"));
+
+  // Only the last digits change, like counting in ex5
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    start = micros();
+    reboot.printf(1, "%04u", i);
+    addTime(micros() - start);
+  }
+  printTimes(F("latency"), clock, F("printf"));
+
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    start = micros();
+    reboot.writeCanvas(numbers[i % 2][0]);
+    addTime(micros() - start);
+  }
+  printTimes(F("latency"), clock, F("write_canvas"));
+
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    start = micros();
+    reboot.setDisplayBrightness(0, i);
+    addTime(micros() - start);
+  }
+  printTimes(F("latency"), clock, F("set_display_brightness"));
+
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    start = micros();
+    reboot.resetDisplay(0);
+    addTime(micros() - start);
+  }
+  printTimes(F("latency"), clock, F("reset_display"));
+}
+
+// Time frames that change every digit of all three displays
+void timeFrames(unsigned long clock)
+{
+  startTimes();
+  for (int i = 0; i < runs; i++)
+  {
+    unsigned long start = micros();
+    reboot.write(0, numbers[i % 2][0]);
+    reboot.write(1, numbers[i % 2][1]);
+    reboot.write(2, numbers[i % 2][2]);
+    addTime(micros() - start);
+  }
+  printTimes(F("frame"), clock, F("all_displays"));
+}
+
+// Time how far apart the frames of a loop paced with delay() really are,
+// the difference between min_us and max_us is the jitter
+void timeJitter(unsigned long clock)
+{
+  startTimes();
+  unsigned long last = micros();
+  for (int i = 0; i <= runs; i++)
+  {
+    unsigned long now = micros();
+    if (i > 0)
+    {
+      addTime(now - last);
+    }
+    last = now;
+
+    reboot.write(0, numbers[i % 2][0]);
+    reboot.write(1, numbers[i % 2][1]);
+    reboot.write(2, numbers[i % 2][2]);
+    delay(framePeriodMs);
+  }
+  printTimes(F("jitter"), clock, F("loop_20ms"));
+}
+
+#if REBOOT_FRAME_CLOCK > 0
+// Same as timeJitter(), but paced by the frame clock, which is only built in
+// when REBOOT_FRAME_CLOCK is set in GhostLab42RebootConfig.h
+void timeFrameClock(unsigned long clock)
+{
+  startTimes();
+  reboot.startFrameClock(framePeriodMs * 1000);
+  unsigned long last = 0;
+  for (int i = 0; i <= runs; i++)
+  {
+    while (reboot.isFrameDue() == false);
+
+    unsigned long now = micros();
+    if (i > 0)
+    {
+      addTime(now - last);
+    }
+    last = now;
+
+    reboot.write(0, numbers[i % 2][0]);
+    reboot.write(1, numbers[i % 2][1]);
+    reboot.write(2, numbers[i % 2][2]);
+  }
+  reboot.stopFrameClock();
+  printTimes(F("jitter"), clock, F("frame_clock_20ms"));
+}
+#endif
+
+void startTimes()
+{
+  minTime = 0xFFFFFFFF;
+  maxTime = 0;
+  totalTime = 0;
+  timeCount = 0;
+}
+
+void addTime(unsigned long time)
+{
+  if (time < minTime) minTime = time;
+  if (time > maxTime) maxTime = time;
+  totalTime += time;
+  timeCount++;
+}
+
+void printTimes(const __FlashStringHelper *kind, unsigned long clock,
+                const __FlashStringHelper *name)
+{
+  unsigned long mean = totalTime / timeCount;
+
+  Serial.print(kind);
+  Serial.print(',');
+  Serial.print(clock);
+  Serial.print(',');
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(timeCount);
+  Serial.print(',');
+  Serial.print(minTime);
+  Serial.print(',');
+  Serial.print(mean);
+  Serial.print(',');
+  Serial.print(maxTime);
+  Serial.print(',');
+  Serial.println(mean > 0 ? 1000000.0 / mean : 0.0, 1);
+}
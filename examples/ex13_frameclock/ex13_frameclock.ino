@@ -0,0 +1,48 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+// The frame clock has to be turned on in GhostLab42RebootConfig.h, by setting
+// REBOOT_FRAME_CLOCK to 1 (Timer1) or 2 (Timer2)
+#if REBOOT_FRAME_CLOCK == 0
+#error "Set REBOOT_FRAME_CLOCK in GhostLab42RebootConfig.h to run this example"
+#endif
+
+GhostLab42Reboot reboot;
+
+// 50 frames per second
+const unsigned long framePeriodUs = 20000;
+
+unsigned long frame = 0;
+
+void setup()
+{
+  Serial.begin(115200);
+  reboot.begin();
+  reboot.startFrameClock(framePeriodUs);
+}
+
+void loop()
+{
+  // Other work can go here, the frames keep their pace as long as it takes
+  // less than a frame
+  reboot.tick();
+
+  if (reboot.isFrameDue() == false) return;
+  frame++;
+
+  // Count the seconds and hundredths, which only stays right if every frame
+  // is drawn on time
+  reboot.printf(0, "%4lu.%02lu", frame / 50, (frame % 50) * 2);
+  reboot.printf(1, "%04lu", frame % 10000);
+
+  // Report the skipped frames every ten seconds
+  if (frame % 500 == 0)
+  {
+    Serial.print(F("missed frames: "));
+    Serial.println(reboot.getMissedFrames());
+
+    // With REBOOT_TRACE_SPANS set, the trace shows when every frame came due
+    // and how late it was picked up, see extras/trace/reboot_trace.py
+    reboot.dumpTrace(Serial);
+  }
+}
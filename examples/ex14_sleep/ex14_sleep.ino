@@ -0,0 +1,37 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// Longest time to sleep for, so the button is still checked regularly
+const unsigned long maxSleepMs = 100;
+
+// Button that restarts the message, wired to ground
+const int buttonPin = 2;
+
+void setup()
+{
+  pinMode(buttonPin, INPUT_PULLUP);
+  reboot.begin();
+
+  // Turning the displays down saves the most power
+  reboot.setDisplayBrightness(0, 30);
+  reboot.setDisplayBrightness(1, 30);
+  reboot.setDisplayBrightness(2, 30);
+
+  reboot.scrollCanvas("WHO YA GONNA CALL", 300, true);
+}
+
+void loop()
+{
+  // tick() returns how long it is until the message moves on, so the loop
+  // sleeps until then instead of spinning in delay()
+  unsigned long wait = reboot.tick();
+
+  if (digitalRead(buttonPin) == LOW)
+  {
+    reboot.scrollCanvas("GHOSTBUSTERS", 300, true);
+  }
+
+  reboot.sleep(min(wait, maxSleepMs));
+}
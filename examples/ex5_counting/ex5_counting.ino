@@ -15,17 +15,16 @@ void setup()
 
 void loop()
 {
-  String countStr;
   int count = 2087;
   
   for (int i = 0; i < 1000; i++)
   {
     // Count down
-    reboot.write(0, String(120999 - i));
+    // Printing to the display formats the number without building a String
+    reboot.display(0).println(120999L - i);
 
     // Count up with leading 0s really fast
-    countStr = "000" + String(16 * i);
-    reboot.write(1, countStr.substring(countStr.length() - 4));
+    reboot.printf(1, "%04u", (16 * i) % 10000);
     
     // Show a number that is about 2087 but moves around randomly by a few counts
     // Slow the update down so it changes more slowly
@@ -34,7 +33,7 @@ void loop()
       count = 2087 + random(-2, 3);
     }
     
-    reboot.write(2, String(count));
+    reboot.display(2).println(count);
 
     delay(30);  
   }
@@ -0,0 +1,40 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// Whether the six digit display is currently blanked
+bool blanked = false;
+
+void setup()
+{
+  reboot.begin();
+
+  // Write values to the displays
+  reboot.write(0, "120999");
+  reboot.write(1, "0000");
+  reboot.write(2, "2087");
+
+  // Blink the smaller four digit display quickly, mostly on
+  reboot.blink(1, 400, 75);
+}
+
+void loop()
+{
+  // Keep the blink effect running
+  reboot.tick();
+
+  // Flash the six digit display by hand, switching every second
+  // The display keeps its characters while it is blanked, so there is no need
+  // to write them again
+  bool shouldBlank = ((millis() / 1000) % 2 == 1);
+
+  // Only talk to the display when it needs to change
+  if (shouldBlank != blanked)
+  {
+    if (shouldBlank) reboot.blank(0);
+    else reboot.unblank(0);
+
+    blanked = shouldBlank;
+  }
+}
@@ -0,0 +1,29 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+void setup()
+{
+  reboot.begin();
+
+  // Write values to the displays
+  reboot.write(0, "120999");
+  reboot.write(1, "126.2");
+  reboot.write(2, "-42.9");
+
+  // Photoresistor voltage divider on A0
+  // Reads about 50 in a dark room and about 900 in daylight
+  // Never go below 5% brightness so the displays stay readable
+  reboot.setAutoBrightness(A0, 50, 900, 5, 100);
+
+  // Read the sensor every 100ms and smooth the readings a lot, so a hand
+  // passing over the sensor does not make the displays flicker
+  reboot.setAutoBrightnessFilter(100, 8, 4, 2);
+}
+
+void loop()
+{
+  // Reads the sensor and updates the brightness when the light changes
+  reboot.tick();
+}
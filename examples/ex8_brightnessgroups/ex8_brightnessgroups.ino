@@ -0,0 +1,47 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// Whether the displays are fading in or out
+bool fadingIn = true;
+
+// When the current fade started
+unsigned long fadeStart = 0;
+
+void setup()
+{
+  reboot.begin();
+
+  // Put all three displays in group 0
+  // The smaller four digit display runs at half the brightness of the others
+  reboot.setBrightnessGroup(0, 0, 100);
+  reboot.setBrightnessGroup(0, 1, 50);
+  reboot.setBrightnessGroup(0, 2, 100);
+
+  // Start with the displays off
+  reboot.setGroupBrightness(0, 0);
+
+  // Write values to the displays
+  reboot.write(0, "8.8.8.8.8.8.");
+  reboot.write(1, "8.8.8.8.");
+  reboot.write(2, "8.8.8.8.");
+
+  // Fade in over two seconds
+  reboot.fadeGroupBrightness(0, 100, 2000);
+  fadeStart = millis();
+}
+
+void loop()
+{
+  // Keep the fade running
+  reboot.tick();
+
+  // Switch direction once the fade is done
+  if (millis() - fadeStart >= 2000)
+  {
+    fadingIn = !fadingIn;
+    reboot.fadeGroupBrightness(0, fadingIn ? 100 : 0, 2000);
+    fadeStart = millis();
+  }
+}
@@ -0,0 +1,51 @@
+#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+// Whether the message or the count is on the canvas
+bool showingMessage = true;
+
+// Number that is counted up after the message
+int count = 0;
+
+// When the count last changed
+unsigned long lastCount = 0;
+
+void setup()
+{
+  reboot.begin();
+
+  // Scroll a message across all three displays, starting on the four-digit
+  // display and ending on the six-digit display. The message is 32 digits
+  // wide, the W takes up two, which is as long as a scroll can be by default
+  reboot.setCanvasOrder(0, 1, 2);
+  reboot.scrollCanvas("Who ya gonna call? Ghostbusters", 250, false);
+}
+
+void loop()
+{
+  // Move the message along
+  reboot.tick();
+
+  if (showingMessage && reboot.isCanvasScrolling() == false)
+  {
+    showingMessage = false;
+  }
+
+  // Count up across the canvas once the message is done
+  // Only the digits that change are sent to the displays
+  if (showingMessage == false && millis() - lastCount >= 100)
+  {
+    lastCount = millis();
+    count++;
+    reboot.writeCanvas("Count " + String(count));
+
+    // Start the message over every thousand counts
+    if (count % 1000 == 0)
+    {
+      showingMessage = true;
+      reboot.scrollCanvas("Who ya gonna call? Ghostbusters", 250, false);
+    }
+  }
+}
@@ -0,0 +1,233 @@
+/*
+ * Host benchmark of the encode and commit paths of the library, run against
+ * a Wire library that only counts the bytes and transactions it is given.
+ * The animations run on a RebootManualClock, so seconds of effects take
+ * milliseconds.
+ *
+ * See documentation/developer/benchmark.md for how to build and run it
+ */
+
+// <chrono> comes first, before Arduino.h defines min() and max()
+#include <chrono>
+#include <Arduino.h>
+#include <Wire.h>
+#include "GhostLab42Reboot.h"
+
+TwoWire Wire;
+
+// Time only moves when the library asks for a delay
+unsigned long hostMillis = 0;
+unsigned long millis() { return hostMillis; }
+unsigned long micros() { return hostMillis * 1000UL; }
+void delay(unsigned long ms) { hostMillis += ms; }
+int analogRead(uint8_t pin) { return 0; }
+
+// Inputs taken from the examples
+const char *ex1Frames[2][REBOOT_DISPLAY_COUNT] =
+{
+  {"9146431", "1923", "5678"},
+  {"1709752", "8210", "4251"}
+};
+const String ex3Text = "      Who ya gonna call?     Ghostbusters!      ";
+const String ex4Text = "       . Test 1.2.3.4.  ...      ";
+
+// ex1: whole numbers on all three displays, every digit changes
+void benchWriteDigits(GhostLab42Reboot &reboot, long i)
+{
+  int displayID = i % REBOOT_DISPLAY_COUNT;
+  int frame = (i / REBOOT_DISPLAY_COUNT) % 2;
+  reboot.write(displayID, ex1Frames[frame][displayID]);
+}
+
+// ex2: a decimal on every digit, only the last decimal changes
+void benchWriteDecimals(GhostLab42Reboot &reboot, long i)
+{
+  reboot.write(0, (i % 2) ? "8.8.8.8.8.8." : "8.8.8.8.8.8");
+}
+
+// ex2: brightness sweep on all three displays
+void benchBrightness(GhostLab42Reboot &reboot, long i)
+{
+  reboot.setDisplayBrightness(i % REBOOT_DISPLAY_COUNT, (i / 3) % 101);
+}
+
+// ex3: six characters at a time of a message
+void benchScrollText(GhostLab42Reboot &reboot, long i)
+{
+  int offset = i % ex3Text.length();
+  reboot.write(0, ex3Text.substring(offset, offset + 6));
+}
+
+// ex4: like ex3, but with decimals in the message
+void benchScrollDecimals(GhostLab42Reboot &reboot, long i)
+{
+  int offset = i % ex4Text.length();
+  reboot.write(0, ex4Text.substring(offset, offset + 8));
+}
+
+// ex5: counting down with println()
+void benchPrintNumber(GhostLab42Reboot &reboot, long i)
+{
+  reboot.display(0).println(120999L - (i % 1000));
+}
+
+// ex5: counting up with printf()
+void benchPrintf(GhostLab42Reboot &reboot, long i)
+{
+  reboot.printf(1, "%04u", (unsigned int)((16 * i) % 10000));
+}
+
+// ex3: glyph lookup and decimal parsing only, nothing is sent
+void benchTextWidth(GhostLab42Reboot &reboot, long i)
+{
+  reboot.getTextWidth(0, ex3Text);
+}
+
+// ex3: clearing a display once the message is done
+void benchReset(GhostLab42Reboot &reboot, long i)
+{
+  reboot.resetDisplay(i % REBOOT_DISPLAY_COUNT);
+}
+
+struct Benchmark
+{
+  const char *name;
+  void (*run)(GhostLab42Reboot &reboot, long i);
+};
+
+const Benchmark benchmarks[] =
+{
+  {"ex1_write_digits", benchWriteDigits},
+  {"ex2_write_decimals", benchWriteDecimals},
+  {"ex2_brightness", benchBrightness},
+  {"ex3_scroll_text", benchScrollText},
+  {"ex4_scroll_decimals", benchScrollDecimals},
+  {"ex5_print_number", benchPrintNumber},
+  {"ex5_printf", benchPrintf},
+  {"ex3_text_width", benchTextWidth},
+  {"ex3_reset", benchReset}
+};
+
+// Length of each animation on the manual clock
+const unsigned long animationMs = 30000;
+
+// ex9: a message scrolling across the canvas
+void animateScroll(GhostLab42Reboot &reboot)
+{
+  reboot.scrollCanvas("WHO YA GONNA CALL", 200, true);
+}
+
+// ex6: all three displays blinking at different rates
+void animateBlink(GhostLab42Reboot &reboot)
+{
+  reboot.write(0, "123456");
+  reboot.write(1, "1234");
+  reboot.write(2, "5678");
+  reboot.blink(0, 1000, 50);
+  reboot.blink(1, 700, 30);
+  reboot.blink(2, 300, 80);
+}
+
+// ex8: a brightness group fading up over the whole animation
+void animateGroupFade(GhostLab42Reboot &reboot)
+{
+  reboot.write(0, "123456");
+  reboot.write(2, "5678");
+  reboot.setBrightnessGroup(0, 0, 100);
+  reboot.setBrightnessGroup(0, 2, 50);
+  reboot.setGroupBrightness(0, 0);
+  reboot.fadeGroupBrightness(0, 100, animationMs);
+}
+
+// A dissolve between two numbers on every display
+void animateTransition(GhostLab42Reboot &reboot)
+{
+  reboot.write(0, ex1Frames[0][0]);
+  reboot.write(1, ex1Frames[0][1]);
+  reboot.write(2, ex1Frames[0][2]);
+  reboot.transition(0, ex1Frames[1][0], REBOOT_DISSOLVE, 2000);
+  reboot.transition(1, ex1Frames[1][1], REBOOT_MORPH, 2000);
+  reboot.transition(2, ex1Frames[1][2], REBOOT_WIPE_TOP_DOWN, 2000);
+}
+
+struct Animation
+{
+  const char *name;
+  void (*start)(GhostLab42Reboot &reboot);
+};
+
+const Animation animations[] =
+{
+  {"ex9_scroll", animateScroll},
+  {"ex6_blink", animateBlink},
+  {"ex8_group_fade", animateGroupFade},
+  {"transition", animateTransition}
+};
+
+int main(int argc, char *argv[])
+{
+  long calls = (argc > 1) ? atol(argv[1]) : 200000L;
+  if (calls < 1) calls = 1;
+
+  printf("%-22s %10s %12s %14s %12s\n", "benchmark", "calls", "ns/call",
+         "bytes/frame", "tx/frame");
+
+  for (unsigned int b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++)
+  {
+    // Every benchmark starts from freshly set up displays
+    GhostLab42Reboot reboot;
+    reboot.begin();
+
+    // Warm up, so the first frame sending every digit is not counted
+    for (long i = 0; i < 16; i++) benchmarks[b].run(reboot, i);
+
+    unsigned long bytes = Wire.bytes;
+    unsigned long transactions = Wire.transactions;
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+    for (long i = 0; i < calls; i++) benchmarks[b].run(reboot, i);
+
+    double ns = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count();
+
+    printf("%-22s %10ld %12.1f %14.2f %12.2f\n", benchmarks[b].name, calls,
+           ns / calls, (double)(Wire.bytes - bytes) / calls,
+           (double)(Wire.transactions - transactions) / calls);
+  }
+
+  // Run each animation the way a sketch that sleeps between the steps would,
+  // with the manual clock moving forward instead of waiting. The bytes and
+  // transactions are exact, so they can be compared between versions.
+  printf("\n%-22s %10s %12s %14s %12s\n", "animation", "virtual_ms",
+         "wall_us", "bytes", "ticks");
+
+  for (unsigned int a = 0; a < sizeof(animations) / sizeof(animations[0]); a++)
+  {
+    RebootManualClock clock;
+    GhostLab42Reboot reboot;
+    reboot.setClock(&clock);
+    reboot.begin();
+    animations[a].start(reboot);
+
+    unsigned long bytes = Wire.bytes;
+    unsigned long ticks = 0;
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+    while (clock.millis() < animationMs)
+    {
+      unsigned long wait = reboot.tick();
+      ticks++;
+      reboot.sleep(max(1UL, min(wait, animationMs - clock.millis())));
+    }
+
+    double us = std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+
+    printf("%-22s %10lu %12.0f %14lu %12lu\n", animations[a].name,
+           animationMs, us, Wire.bytes - bytes, ticks);
+  }
+
+  return 0;
+}
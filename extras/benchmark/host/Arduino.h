@@ -0,0 +1,120 @@
+/*
+ * Just enough of the Arduino core to build the library on a computer for the
+ * benchmark, see documentation/developer/benchmark.md
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// There is only one kind of memory, so flash reads are plain reads
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define memcpy_P memcpy
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+#define DEC 10
+#define HEX 16
+#define A0 14
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define abs(x) ((x) > 0 ? (x) : -(x))
+#define constrain(amt, low, high) \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Time only moves when delay() is called, so runs are repeatable
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+int analogRead(uint8_t pin);
+
+class String
+{
+  public:
+    String(const char *value = "") : text(value) {}
+    String(const std::string &value) : text(value) {}
+    String(int value) : text(std::to_string(value)) {}
+    String(long value) : text(std::to_string(value)) {}
+    unsigned int length() const { return text.size(); }
+    char charAt(unsigned int index) const
+    {
+      return index < text.size() ? text[index] : 0;
+    }
+    const char *c_str() const { return text.c_str(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+      if (from > text.size()) from = text.size();
+      if (to < from) to = from;
+      return String(text.substr(from, to - from));
+    }
+  private:
+    std::string text;
+};
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      size_t count = 0;
+      while (size--) count += write(*buffer++);
+      return count;
+    }
+    size_t write(const char *value)
+    {
+      return write((const uint8_t *)value, strlen(value));
+    }
+    size_t print(const char *value) { return write(value); }
+    size_t print(const __FlashStringHelper *value)
+    {
+      return write((const char *)value);
+    }
+    size_t print(char value) { return write((uint8_t)value); }
+    size_t print(const String &value) { return write(value.c_str()); }
+    size_t print(long value, int base = DEC)
+    {
+      char digits[34];
+      snprintf(digits, sizeof(digits), base == HEX ? "%lX" : "%ld", value);
+      return write(digits);
+    }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned long value, int base = DEC)
+    {
+      char digits[34];
+      snprintf(digits, sizeof(digits), base == HEX ? "%lX" : "%lu", value);
+      return write(digits);
+    }
+    size_t print(unsigned int value, int base = DEC)
+    {
+      return print((unsigned long)value, base);
+    }
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value)
+    {
+      size_t count = print(value);
+      return count + println();
+    }
+};
+
+#endif
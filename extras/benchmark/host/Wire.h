@@ -0,0 +1,61 @@
+/*
+ * Stand-in for the Wire library that counts what would have been sent over
+ * the I2C bus instead of sending it, and keeps the registers of every board
+ * as they were last written, see documentation/developer/benchmark.md
+ */
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+class TwoWire
+{
+  public:
+    // Bytes (including the address byte) and transactions so far
+    unsigned long bytes;
+    unsigned long transactions;
+
+    // Registers of each board by I2C address. The first byte of a
+    // transaction is the register index, and the index moves on with every
+    // byte after it, like the IS31FL3730 does.
+    uint8_t registers[128][256];
+
+    TwoWire() : bytes(0), transactions(0), address(0), index(0),
+                indexSet(false)
+    {
+      memset(registers, 0, sizeof(registers));
+    }
+    void begin() {}
+    void setClock(uint32_t clock) {}
+    void beginTransmission(uint8_t address)
+    {
+      bytes++;
+      transactions++;
+      this->address = address & 0x7F;
+      indexSet = false;
+    }
+    size_t write(uint8_t value)
+    {
+      bytes++;
+      if (indexSet == false)
+      {
+        index = value;
+        indexSet = true;
+      }
+      else
+      {
+        registers[address][index++] = value;
+      }
+      return 1;
+    }
+    uint8_t endTransmission(bool stop = true) { return 0; }
+  private:
+    uint8_t address;
+    uint8_t index;
+    bool indexSet;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ * Host test of the time based effects, played back on a RebootManualClock so
+ * seconds of animation take no time at all. At set times on the clock the
+ * registers of the displays and the bytes sent over the I2C bus are checked
+ * against what the effects are expected to send.
+ *
+ * See documentation/developer/benchmark.md for how to build and run it
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "GhostLab42Reboot.h"
+
+TwoWire Wire;
+
+// Nothing may read the time without going through the clock
+unsigned long millis() { return 0; }
+unsigned long micros() { return 0; }
+void delay(unsigned long ms) {}
+int analogRead(uint8_t pin) { return 0; }
+
+// I2C addresses of the displays
+const byte display0 = 0x60;
+const byte display1 = 0x61;
+const byte display2 = 0x63;
+
+// Registers of the IS31FL3730
+const byte configRegister = 0x00;
+const byte dataRegister = 0x01;
+const byte currentRegister = 0x0D;
+const byte pwmRegister = 0x19;
+
+const byte shutdown = 0x80;
+
+RebootManualClock manualClock;
+unsigned long startMs;
+unsigned long startBytes;
+int failures = 0;
+
+// Starts a test on a freshly set up library, with the clock at 0 ms of the
+// test and the registers of the stand-in Wire library cleared
+void start(GhostLab42Reboot &reboot)
+{
+  reboot.setClock(&manualClock);
+  reboot.begin();
+  memset(Wire.registers, 0, sizeof(Wire.registers));
+  startMs = manualClock.millis();
+  startBytes = Wire.bytes;
+}
+
+// Plays the effects back until the given time of the test, the way a sketch
+// that sleeps until the deadline from tick() would, and ticks once more at
+// that time
+void runUntil(GhostLab42Reboot &reboot, unsigned long ms)
+{
+  while (manualClock.millis() - startMs < ms)
+  {
+    unsigned long wait = reboot.tick();
+    unsigned long left = ms - (manualClock.millis() - startMs);
+    if (wait == 0) wait = 1;
+    manualClock.advance(wait < left ? wait : left);
+  }
+  reboot.tick();
+}
+
+void expectRegister(const char *name, byte address, byte index, byte value)
+{
+  byte actual = Wire.registers[address][index];
+  if (actual == value) return;
+
+  failures++;
+  printf("FAIL %s at %lu ms: register %02X of %02X is %02X, expected %02X\n",
+         name, manualClock.millis() - startMs, index, address, actual, value);
+}
+
+// Checks the data registers of a four-digit display
+void expectDigits(const char *name, byte address, byte d1, byte d2, byte d3,
+                  byte d4)
+{
+  expectRegister(name, address, dataRegister, d1);
+  expectRegister(name, address, dataRegister + 1, d2);
+  expectRegister(name, address, dataRegister + 2, d3);
+  expectRegister(name, address, dataRegister + 3, d4);
+}
+
+// Checks the bytes sent since the test started
+void expectBytes(const char *name, unsigned long bytes)
+{
+  unsigned long actual = Wire.bytes - startBytes;
+  if (actual == bytes) return;
+
+  failures++;
+  printf("FAIL %s at %lu ms: %lu bytes sent, expected %lu\n", name,
+         manualClock.millis() - startMs, actual, bytes);
+}
+
+// Checks the current the library estimates all displays draw together
+void expectCurrent(const char *name, GhostLab42Reboot &reboot,
+                   unsigned int milliamps)
+{
+  unsigned int actual = reboot.getEstimatedCurrent();
+  if (actual == milliamps) return;
+
+  failures++;
+  printf("FAIL %s at %lu ms: %u mA estimated, expected %u mA\n", name,
+         manualClock.millis() - startMs, actual, milliamps);
+}
+
+// ex9: "HELLO" comes in on the right of the canvas, one digit every 200 ms
+void testScroll()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.scrollCanvas("HELLO", 200, false);
+
+  runUntil(reboot, 199);
+  expectDigits("scroll", display2, 0x00, 0x00, 0x00, 0x76);
+  expectBytes("scroll", 12);
+
+  runUntil(reboot, 200);
+  expectDigits("scroll", display2, 0x00, 0x00, 0x76, 0x79);
+  expectBytes("scroll", 25);
+
+  // Five steps later the message is split over the last two displays
+  runUntil(reboot, 1000);
+  expectDigits("scroll", display1, 0x00, 0x00, 0x76, 0x79);
+  expectDigits("scroll", display2, 0x38, 0x38, 0x3F, 0x00);
+  expectBytes("scroll", 108);
+}
+
+// ex6: on for 300 ms, then off for 700 ms
+void testBlink()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.write(0, "123456");
+  reboot.blink(0, 1000, 30);
+  unsigned long bytes = Wire.bytes - startBytes;
+
+  runUntil(reboot, 299);
+  expectRegister("blink", display0, configRegister, 0x00);
+  expectBytes("blink", bytes);
+
+  // Only the shutdown bit is sent, the digits stay in the data registers
+  runUntil(reboot, 300);
+  expectRegister("blink", display0, configRegister, shutdown);
+  expectRegister("blink", display0, dataRegister, 0x06);
+  expectBytes("blink", bytes + 3);
+
+  runUntil(reboot, 999);
+  expectRegister("blink", display0, configRegister, shutdown);
+
+  runUntil(reboot, 1000);
+  expectRegister("blink", display0, configRegister, 0x00);
+  expectBytes("blink", bytes + 6);
+}
+
+// ex8: a brightness group fading from 0% to 100% over a second
+void testFade()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.write(2, "5678");
+  reboot.setBrightnessGroup(0, 2, 100);
+  reboot.setGroupBrightness(0, 0);
+  reboot.fadeGroupBrightness(0, 100, 1000);
+
+  // 50% brightness is 0x18 in the light correction table
+  runUntil(reboot, 500);
+  expectRegister("fade", display2, pwmRegister, 0x18);
+
+  runUntil(reboot, 1000);
+  expectRegister("fade", display2, pwmRegister, 0x80);
+  expectDigits("fade", display2, 0x6D, 0x7D, 0x07, 0x7F);
+  expectBytes("fade", 237);
+}
+
+// A wipe from the left over 400 ms, a digit at a time, every step setting the
+// current again (3 bytes) before the digits
+void testTransition()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.write(1, "1111");
+  unsigned long bytes = Wire.bytes - startBytes;
+  reboot.transition(1, "2222", REBOOT_WIPE_LEFT_TO_RIGHT, 400);
+
+  runUntil(reboot, 50);
+  expectDigits("transition", display1, 0x06, 0x06, 0x06, 0x06);
+
+  // The display was unplugged and came back at the 40mA default (0x00), the
+  // next step sets the current again before it sends the digits
+  Wire.registers[display1][currentRegister] = 0x00;
+  runUntil(reboot, 100);
+  expectRegister("transition", display1, currentRegister, 0x0B);
+
+  runUntil(reboot, 200);
+  expectDigits("transition", display1, 0x5B, 0x5B, 0x06, 0x06);
+
+  runUntil(reboot, 400);
+  expectDigits("transition", display1, 0x5B, 0x5B, 0x5B, 0x5B);
+  expectBytes("transition", bytes + 39);
+}
+
+// A crossfade to a fully lit display with a 20mA current budget. The display
+// is held to the budget (5mA and PWM 0x54) while both frames are shown, and
+// stays there once only the new one is.
+void testCrossfadeBudget()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.setCurrentBudget(20);
+  reboot.write(0, "1");
+  reboot.crossfade(0, "8.8.8.8.8.8.", 400);
+
+  expectRegister("crossfade budget", display0, currentRegister, 0x08);
+  expectRegister("crossfade budget", display0, pwmRegister, 0x54);
+  expectCurrent("crossfade budget", reboot, 20);
+
+  runUntil(reboot, 400);
+  expectRegister("crossfade budget", display0, currentRegister, 0x08);
+  expectRegister("crossfade budget", display0, pwmRegister, 0x54);
+  expectRegister("crossfade budget", display0, dataRegister, 0xFF);
+  expectCurrent("crossfade budget", reboot, 20);
+}
+
+// The same for a wipe, whose steps show digits of both frames side by side
+void testWipeBudget()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.setCurrentBudget(20);
+  reboot.write(0, "1");
+  reboot.transition(0, "8.8.8.8.8.8.", REBOOT_WIPE_LEFT_TO_RIGHT, 400);
+
+  expectRegister("wipe budget", display0, currentRegister, 0x08);
+  expectRegister("wipe budget", display0, pwmRegister, 0x54);
+  expectCurrent("wipe budget", reboot, 20);
+
+  runUntil(reboot, 200);
+  expectRegister("wipe budget", display0, currentRegister, 0x08);
+  expectRegister("wipe budget", display0, pwmRegister, 0x54);
+
+  runUntil(reboot, 400);
+  expectRegister("wipe budget", display0, currentRegister, 0x08);
+  expectRegister("wipe budget", display0, pwmRegister, 0x54);
+  expectRegister("wipe budget", display0, dataRegister + 5, 0xFF);
+  expectCurrent("wipe budget", reboot, 20);
+}
+
+// The idle timeout shuts a display down a second after it was written to,
+// and the next write turns it back on
+void testIdle()
+{
+  GhostLab42Reboot reboot;
+  start(reboot);
+  reboot.setIdleTimeout(1000);
+  reboot.write(0, "8");
+  unsigned long bytes = Wire.bytes - startBytes;
+
+  runUntil(reboot, 999);
+  expectRegister("idle", display0, configRegister, 0x00);
+  expectBytes("idle", bytes);
+
+  runUntil(reboot, 1000);
+  expectRegister("idle", display0, configRegister, shutdown);
+  expectRegister("idle", display0, dataRegister, 0x7F);
+  expectBytes("idle", bytes + 9);
+
+  reboot.write(0, "9");
+  expectRegister("idle", display0, configRegister, 0x00);
+  expectRegister("idle", display0, dataRegister, 0x6F);
+}
+
+int main()
+{
+  testScroll();
+  testBlink();
+  testFade();
+  testTransition();
+  testCrossfadeBudget();
+  testWipeBudget();
+  testIdle();
+
+  if (failures == 0) printf("All animation tests passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/*
+ * Host test of how write() turns characters and decimals into digits, run
+ * against the Wire library in extras/benchmark/host, which keeps the data
+ * registers of every display as they were last written
+ *
+ * See documentation/developer/benchmark.md for how to build and run it
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "GhostLab42Reboot.h"
+
+TwoWire Wire;
+
+unsigned long millis() { return 0; }
+unsigned long micros() { return 0; }
+void delay(unsigned long ms) {}
+int analogRead(uint8_t pin) { return 0; }
+
+// I2C address and first data register of the six-digit display
+const byte displayAddress = 0x60;
+const byte dataRegister = 0x01;
+
+int failures = 0;
+
+// Writes the characters to the six-digit display and checks the segment data
+// (gfedcba, with 0x80 for the decimal) of every digit
+void check(GhostLab42Reboot &reboot, const char *text, int alignment,
+           int overflow, const byte expected[REBOOT_MAX_DIGITS])
+{
+  reboot.write(0, text, alignment, overflow);
+
+  const uint8_t *digits = &Wire.registers[displayAddress][dataRegister];
+  if (memcmp(digits, expected, REBOOT_MAX_DIGITS) == 0) return;
+
+  failures++;
+  printf("FAIL \"%s\": expected", text);
+  for (int i = 0; i < REBOOT_MAX_DIGITS; i++) printf(" %02X", expected[i]);
+  printf(", got");
+  for (int i = 0; i < REBOOT_MAX_DIGITS; i++) printf(" %02X", digits[i]);
+  printf("\n");
+}
+
+void check(GhostLab42Reboot &reboot, const char *text,
+           const byte expected[REBOOT_MAX_DIGITS])
+{
+  check(reboot, text, REBOOT_ALIGN_LEFT, REBOOT_OVERFLOW_TRUNCATE, expected);
+}
+
+int main()
+{
+  GhostLab42Reboot reboot;
+  reboot.begin();
+
+  // A decimal is added to the character before it
+  const byte trailing[] = {0x06, 0xDB, 0x00, 0x00, 0x00, 0x00};
+  check(reboot, "12.", trailing);
+
+  // A decimal at the start has no character before it, so it gets a blank
+  // digit of its own
+  const byte leading[] = {0x80, 0x6D, 0x00, 0x00, 0x00, 0x00};
+  check(reboot, ".5", leading);
+
+  // So does a decimal right after another decimal
+  const byte twoDecimals[] = {0x80, 0x80, 0x00, 0x00, 0x00, 0x00};
+  check(reboot, "..", twoDecimals);
+  const byte doubleDecimal[] = {0x86, 0x80, 0x5B, 0x00, 0x00, 0x00};
+  check(reboot, "1..2", doubleDecimal);
+
+  // The decimal of a character that takes up two digits goes on its last
+  // digit
+  const byte wide[] = {0x33, 0xA7, 0x00, 0x00, 0x00, 0x00};
+  check(reboot, "M.", wide);
+
+  const byte minus[] = {0xC0, 0x00, 0x00, 0x00, 0x00, 0x00};
+  check(reboot, "-.", minus);
+
+  // Characters the font does not have are blank, but keep their decimal
+  const byte unknown[] = {0x80, 0x06, 0x00, 0x00, 0x00, 0x00};
+  check(reboot, "@.1", unknown);
+
+  // Text that does not fit is cut off at the end, or at the start when it
+  // is lined up on the right, and decimals stay with their characters
+  const byte cutEnd[] = {0x06, 0x5B, 0xCF, 0x66, 0x6D, 0x7D};
+  check(reboot, "123.4567", cutEnd);
+  const byte cutStart[] = {0x5B, 0xCF, 0x66, 0x6D, 0x7D, 0x07};
+  check(reboot, "123.4567", REBOOT_ALIGN_RIGHT, REBOOT_OVERFLOW_TRUNCATE,
+        cutStart);
+
+  // The ellipsis marks the digit where the text was cut off
+  const byte ellipsis[] = {0x06, 0x5B, 0xCF, 0x66, 0x6D, 0x80};
+  check(reboot, "123.4567", REBOOT_ALIGN_LEFT, REBOOT_OVERFLOW_ELLIPSIS,
+        ellipsis);
+
+  // A character that takes up two digits is cut off between its digits
+  const byte wideCut[] = {0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x33};
+  check(reboot, "12345M", wideCut);
+
+  if (failures == 0) printf("All decimal tests passed\n");
+  return failures == 0 ? 0 : 1;
+}
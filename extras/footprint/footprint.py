@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+Measures the flash and RAM (SRAM) each feature of the library costs on a
+board, by compiling a small sketch for every feature with arduino-cli and
+comparing it to a sketch that only writes to a display. The same sketch is
+then compiled with each configuration of GhostLab42RebootConfig.h.
+
+Usage:
+  footprint.py [--fqbn arduino:avr:uno] [--markdown]
+
+Needs arduino-cli with the core of the board installed
+(arduino-cli core install arduino:avr). See
+documentation/developer/footprint.md for more information.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+LIBRARY = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+
+# Sketch every feature is compared to
+BASELINE = 'reboot.write(0, "1");'
+
+# Features, with the code added to setup() and the defines the library is
+# compiled with
+FEATURES = [
+    ("brightness", "reboot.setDisplayBrightness(0, 50);", []),
+    ("reset", "reboot.resetDisplay(0);", []),
+    ("blink", "reboot.blink(0, 500, 50); reboot.tick();", []),
+    ("idle_timeout", "reboot.setIdleTimeout(1000); reboot.tick();", []),
+    ("current_budget", "reboot.setCurrentBudget(100);", []),
+    ("display_current", "reboot.setDisplayCurrent(0, 10);", []),
+    ("auto_brightness",
+     "reboot.setAutoBrightness(A0, 0, 1023, 0, 100); reboot.tick();", []),
+    ("brightness_groups",
+     "reboot.setBrightnessGroup(0, 0, 100); "
+     "reboot.fadeGroupBrightness(0, 50, 1000); reboot.tick();", []),
+    ("crossfade", 'reboot.crossfade(0, "2", 500); reboot.tick();', []),
+    ("transition",
+     'reboot.transition(0, "2", REBOOT_DISSOLVE, 500); reboot.tick();', []),
+    ("aligned_write", 'reboot.write(0, "2", REBOOT_ALIGN_RIGHT);', []),
+    ("print", "reboot.display(0).println(42);", []),
+    ("printf", 'reboot.printf(0, "%04u", 42);', []),
+    ("canvas", 'reboot.writeCanvas("HELLO");', []),
+    ("canvas_scroll",
+     'reboot.scrollCanvas("HELLO", 200, true); reboot.tick();', []),
+    ("mirrors", "reboot.addMirror(0, 0x62, 0);", []),
+    ("orientation",
+     "reboot.setDisplayOrientation(0, REBOOT_ROTATE_180);", []),
+    ("alternate_font",
+     "reboot.setDisplayFont(0, &rebootAlternateFont);", []),
+    ("frame_cache_8", "", ["REBOOT_FRAME_CACHE=8"]),
+    ("trace_64", "", ["REBOOT_TRACE_SPANS=64"]),
+    ("frame_clock_timer1",
+     "reboot.startFrameClock(20000); reboot.isFrameDue();",
+     ["REBOOT_FRAME_CLOCK=1"]),
+]
+
+# Configurations of GhostLab42RebootConfig.h, each compiled with the
+# baseline sketch
+ALL_OFF = ["REBOOT_ENABLE_PRINT=0", "REBOOT_ENABLE_BLINK=0",
+           "REBOOT_ENABLE_IDLE_TIMEOUT=0", "REBOOT_ENABLE_CURRENT_BUDGET=0",
+           "REBOOT_ENABLE_CANVAS=0", "REBOOT_ENABLE_ORIENTATION=0",
+           "REBOOT_ENABLE_FONTS=0", "REBOOT_ENABLE_CLOCK=0",
+           "REBOOT_ENABLE_TRANSITIONS=0", "REBOOT_ENABLE_SCROLL=0",
+           "REBOOT_ENABLE_AUTO_BRIGHTNESS=0", "REBOOT_ENABLE_GROUPS=0",
+           "REBOOT_ENABLE_STATISTICS=0", "REBOOT_MIRROR_COUNT=0"]
+CONFIGURATIONS = [
+    ("config_minimal", ALL_OFF),
+    ("config_no_effects", ["REBOOT_ENABLE_TRANSITIONS=0",
+                           "REBOOT_ENABLE_SCROLL=0",
+                           "REBOOT_ENABLE_GROUPS=0"]),
+    ("config_no_print", ["REBOOT_ENABLE_PRINT=0"]),
+    ("config_no_blink", ["REBOOT_ENABLE_BLINK=0"]),
+    ("config_no_idle_timeout", ["REBOOT_ENABLE_IDLE_TIMEOUT=0"]),
+    ("config_no_current_budget", ["REBOOT_ENABLE_CURRENT_BUDGET=0"]),
+    ("config_no_canvas", ["REBOOT_ENABLE_CANVAS=0"]),
+    ("config_no_orientation", ["REBOOT_ENABLE_ORIENTATION=0"]),
+    ("config_no_fonts", ["REBOOT_ENABLE_FONTS=0"]),
+    ("config_no_clock", ["REBOOT_ENABLE_CLOCK=0"]),
+    ("config_no_transitions", ["REBOOT_ENABLE_TRANSITIONS=0"]),
+    ("config_no_scroll", ["REBOOT_ENABLE_SCROLL=0"]),
+    ("config_no_auto_brightness", ["REBOOT_ENABLE_AUTO_BRIGHTNESS=0"]),
+    ("config_no_groups", ["REBOOT_ENABLE_GROUPS=0"]),
+    ("config_no_statistics", ["REBOOT_ENABLE_STATISTICS=0"]),
+    ("config_no_mirrors", ["REBOOT_MIRROR_COUNT=0"]),
+]
+
+SKETCH = """#include <GhostLab42Reboot.h>
+#include <Wire.h>
+
+GhostLab42Reboot reboot;
+
+void setup()
+{
+  reboot.begin();
+  %s
+  %s
+}
+
+void loop()
+{
+}
+"""
+
+
+def compile_sketch(directory, name, code, defines, fqbn):
+    """Returns the flash and RAM a sketch uses"""
+    sketch = os.path.join(directory, name)
+    os.mkdir(sketch)
+    with open(os.path.join(sketch, name + ".ino"), "w") as ino:
+        ino.write(SKETCH % (BASELINE, code))
+
+    command = ["arduino-cli", "compile", "--fqbn", fqbn,
+               "--library", LIBRARY, sketch]
+    if defines:
+        # Defines go to every file, so the sketch and the library agree
+        flags = " ".join("-D" + define for define in defines)
+        command += ["--build-property", "compiler.cpp.extra_flags=" + flags]
+
+    result = subprocess.run(command, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise SystemExit("%s did not compile" % name)
+
+    flash = re.search(r"Sketch uses (\d+) bytes", result.stdout)
+    ram = re.search(r"Global variables use (\d+) bytes", result.stdout)
+    if not flash or not ram:
+        sys.stderr.write(result.stdout)
+        raise SystemExit("could not find the size of %s" % name)
+
+    return int(flash.group(1)), int(ram.group(1))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure the flash and RAM cost of each library feature")
+    parser.add_argument("--fqbn", default="arduino:avr:uno",
+                        help="board to compile for (default: %(default)s)")
+    parser.add_argument("--markdown", action="store_true",
+                        help="print a Markdown table instead of CSV")
+    args = parser.parse_args()
+
+    if shutil.which("arduino-cli") is None:
+        raise SystemExit("arduino-cli was not found")
+
+    directory = tempfile.mkdtemp(prefix="reboot_footprint_")
+    try:
+        rows = []
+        base_flash, base_ram = compile_sketch(directory, "baseline", "", [],
+                                              args.fqbn)
+        rows.append(("baseline", base_flash, base_ram, 0, 0))
+
+        for name, code, defines in FEATURES:
+            flash, ram = compile_sketch(directory, name, code, defines,
+                                        args.fqbn)
+            rows.append((name, flash, ram, flash - base_flash,
+                         ram - base_ram))
+
+        for name, defines in CONFIGURATIONS:
+            flash, ram = compile_sketch(directory, name, "", defines,
+                                        args.fqbn)
+            rows.append((name, flash, ram, flash - base_flash,
+                         ram - base_ram))
+    finally:
+        shutil.rmtree(directory)
+
+    if args.markdown:
+        print("| Feature | Flash | RAM | Flash added | RAM added |")
+        print("| ------- | ----- | --- | ----------- | --------- |")
+        for row in rows:
+            print("| %s | %d | %d | %d | %d |" % row)
+    else:
+        print("feature,flash,ram,flash_added,ram_added")
+        for row in rows:
+            print("%s,%d,%d,%d,%d" % row)
+
+
+if __name__ == "__main__":
+    main()
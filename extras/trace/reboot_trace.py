@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Turns the output of GhostLab42Reboot::dumpTrace() into a Chrome trace (JSON)
+that can be opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing
+
+Usage:
+  reboot_trace.py [dump.txt] [-o trace.json]
+
+The dump is read from standard input when no file is given, and can be mixed
+with other serial output, since only the "trace" and "span" lines are used.
+When the dump has frames of the frame clock, the period and jitter of the
+frames are printed as well.
+See documentation/functions/dumptrace.md for more information.
+"""
+
+import argparse
+import json
+import sys
+
+# Names of the boards on the I2C bus, by address
+BOARD_NAMES = {
+    0x60: "display 0 (0x60)",
+    0x61: "display 1 (0x61)",
+    0x63: "display 2 (0x63)",
+    0x70: "mux (0x70)",
+}
+
+# Every kind of span gets its own row (thread) in the trace, transactions are
+# grouped under the I2C bus and the rest under the library
+BUS_PROCESS = 1
+LIBRARY_PROCESS = 2
+
+
+def span_row(kind, span_id):
+    """Returns the process, thread and thread name a span is shown in"""
+    if kind == "transaction":
+        name = BOARD_NAMES.get(span_id, "board 0x%02X" % span_id)
+        return BUS_PROCESS, span_id, name
+    if kind in ("commit", "transition", "blink", "idle"):
+        return LIBRARY_PROCESS, 1 + span_id, "display %d" % span_id
+    if kind == "fade":
+        return LIBRARY_PROCESS, 10 + span_id, "group %d" % span_id
+    if kind == "scroll":
+        return LIBRARY_PROCESS, 20, "canvas"
+    if kind == "frame":
+        return LIBRARY_PROCESS, 30, "frame clock"
+    if kind == "light":
+        return LIBRARY_PROCESS, 40, "light sensor"
+    return LIBRARY_PROCESS, 0, "tick"
+
+
+def convert(lines):
+    """Returns the Chrome trace events for the lines of one or more dumps"""
+    events = []
+    rows = {}
+    dropped = 0
+    frames = []
+
+    # micros() wraps around about every 71 minutes, so starts that jump back
+    # by more than half the range are moved to the next wrap
+    wraps = 0
+    last_start = None
+
+    for line in lines:
+        fields = line.strip().split(",")
+
+        if fields[0] == "trace" and len(fields) == 3:
+            dropped += int(fields[2])
+            continue
+        if fields[0] != "span" or len(fields) != 5:
+            continue
+
+        kind = fields[1]
+        span_id = int(fields[2])
+        start = int(fields[3])
+        duration = int(fields[4])
+
+        if last_start is not None and last_start - start > 0x80000000:
+            wraps += 1
+        last_start = start
+        start += wraps * 0x100000000
+
+        if kind == "frame":
+            frames.append((start, duration, span_id))
+
+        pid, tid, row_name = span_row(kind, span_id)
+        rows[(pid, tid)] = row_name
+
+        name = kind
+        if kind == "transaction":
+            name = "0x%02X" % span_id
+        elif kind in ("commit", "transition", "blink", "idle"):
+            name = "%s %d" % (kind, span_id)
+
+        events.append({
+            "name": name,
+            "cat": kind,
+            "ph": "X",
+            "ts": start,
+            "dur": duration,
+            "pid": pid,
+            "tid": tid,
+        })
+
+    # Name the processes and rows
+    for pid, name in ((BUS_PROCESS, "I2C bus"), (LIBRARY_PROCESS, "library")):
+        events.append({"name": "process_name", "ph": "M", "pid": pid,
+                       "tid": 0, "args": {"name": name}})
+    for (pid, tid), name in sorted(rows.items()):
+        events.append({"name": "thread_name", "ph": "M", "pid": pid,
+                       "tid": tid, "args": {"name": name}})
+
+    return events, dropped, frames
+
+
+def frame_summary(frames):
+    """
+    Returns a line about the pace of the frame clock: the time between the
+    starts of the frames the sketch drew (when each frame span ends), how
+    late the sketch was to pick up a frame, and the frames that were skipped
+    """
+    frames = sorted(frames)
+    periods = [(b[0] + b[1]) - (a[0] + a[1])
+               for a, b in zip(frames, frames[1:])]
+    latencies = [duration for _, duration, _ in frames]
+    skipped = sum(span_id for _, _, span_id in frames)
+
+    line = "%d frames, %d skipped, latency %d-%d us" % (
+        len(frames), skipped, min(latencies), max(latencies))
+    if periods:
+        mean = sum(periods) / float(len(periods))
+        line += ", period %d-%d us (mean %.1f us, jitter %d us)" % (
+            min(periods), max(periods), mean, max(periods) - min(periods))
+    return line
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert a GhostLab42Reboot trace dump to a Chrome trace")
+    parser.add_argument("dump", nargs="?", help="dump file (default: stdin)")
+    parser.add_argument("-o", "--output", help="trace file (default: stdout)")
+    args = parser.parse_args()
+
+    if args.dump:
+        with open(args.dump) as dump:
+            events, dropped, frames = convert(dump)
+    else:
+        events, dropped, frames = convert(sys.stdin)
+
+    if frames:
+        sys.stderr.write(frame_summary(frames) + "\n")
+
+    if dropped:
+        sys.stderr.write("%d spans were overwritten before they were dumped, "
+                         "dump more often or raise REBOOT_TRACE_SPANS\n"
+                         % dropped)
+
+    trace = {"traceEvents": events, "displayTimeUnit": "ms"}
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(trace, output)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()